@@ -32,6 +32,18 @@ namespace Mus {
             Total
         };
 
+        enum TangentSpaceList : std::uint8_t {
+            FaceTangent = 0, // sum of the face tangents
+            MikkTSpace,      // angle weighted tangents projected per corner, like MikkTSpace
+            TangentSpaceTotal
+        };
+
+        enum NormalInterpolationList : std::uint8_t {
+            Slerp = 0, // pairwise slerp of the vertex vectors
+            Nlerp,     // barycentric weighted sum, normalized once
+            NormalInterpolationTotal
+        };
+
         //Debug
         [[nodiscard]] inline spdlog::level::level_enum GetLogLevel() const noexcept {
             return logLevel;
@@ -147,6 +159,12 @@ namespace Mus {
         [[nodiscard]] inline auto GetAllowInvertNormalSmooth() const noexcept {
             return AllowInvertNormalSmooth;
         }
+        [[nodiscard]] inline auto GetAngleWeightedNormals() const noexcept {
+            return AngleWeightedNormals;
+        }
+        [[nodiscard]] inline auto GetTangentSpace() const noexcept {
+            return TangentSpace;
+        }
         [[nodiscard]] inline auto GetSubdivision() const noexcept {
             return Subdivision;
         }
@@ -159,6 +177,15 @@ namespace Mus {
         [[nodiscard]] inline auto GetSubdivisionVertexSmoothStrength() const noexcept {
             return SubdivisionVertexSmoothStrength;
         }
+        [[nodiscard]] inline auto GetSubdivisionAdaptive() const noexcept {
+            return SubdivisionAdaptive;
+        }
+        [[nodiscard]] inline auto GetSubdivisionTexelThreshold() const noexcept {
+            return SubdivisionTexelThreshold;
+        }
+        [[nodiscard]] inline auto GetSubdivisionAngleThreshold() const noexcept {
+            return SubdivisionAngleThreshold;
+        }
         [[nodiscard]] inline auto GetVertexSmooth() const noexcept {
             return VertexSmooth;
         }
@@ -191,6 +218,12 @@ namespace Mus {
         [[nodiscard]] inline auto GetIgnoreMissingNormalMap() const noexcept {
             return IgnoreMissingNormalMap;
         }
+        [[nodiscard]] inline auto GetNormalInterpolation() const noexcept {
+            return NormalInterpolation;
+        }
+        [[nodiscard]] inline auto GetOrthogonalizeTangent() const noexcept {
+            return OrthogonalizeTangent;
+        }
 
         //Performance
         [[nodiscard]] inline auto GetGPUEnable() const noexcept {
@@ -251,6 +284,21 @@ namespace Mus {
         [[nodiscard]] inline auto GetDiskCacheHashPrecision() const noexcept {
             return DiskCacheHashPrecision;
         }
+        [[nodiscard]] inline auto GetTopologyCacheSize() const noexcept {
+            return TopologyCacheSize;
+        }
+        [[nodiscard]] inline auto GetFaceDataRebuildThreshold() const noexcept {
+            return FaceDataRebuildThreshold;
+        }
+        [[nodiscard]] inline auto GetGeometryDataPoolSize() const noexcept {
+            return GeometryDataPoolSize;
+        }
+        [[nodiscard]] inline auto GetTriangleReorder() const noexcept {
+            return TriangleReorder;
+        }
+        [[nodiscard]] inline auto GetSourceTextureCacheSize() const noexcept {
+            return SourceTextureCacheSize;
+        }
 
         //RealtimeDetect
         [[nodiscard]] inline auto GetRealtimeDetect() const noexcept {
@@ -318,10 +366,15 @@ namespace Mus {
         bool WeldAccuracy = true;
         float NormalSmoothDegree = 60.0f;
         bool AllowInvertNormalSmooth = false;
+        bool AngleWeightedNormals = false;
+        std::uint8_t TangentSpace = TangentSpaceList::FaceTangent;
         std::uint8_t Subdivision = 0;
         std::uint32_t SubdivisionTriThreshold = 65535;
         std::uint8_t SubdivisionVertexSmooth = 1;
         float SubdivisionVertexSmoothStrength = 0.5f;
+        bool SubdivisionAdaptive = false;
+        float SubdivisionTexelThreshold = 64.0f;
+        float SubdivisionAngleThreshold = 30.0f;
         std::uint8_t VertexSmooth = 0;
         float VertexSmoothStrength = 0.5f;
         std::uint8_t VertexSmoothByAngle = 0;
@@ -334,6 +387,8 @@ namespace Mus {
         bool TangentZCorrection = true;
         float DetailStrength = 0.5f;
         bool IgnoreMissingNormalMap = true;
+        std::uint8_t NormalInterpolation = NormalInterpolationList::Slerp;
+        bool OrthogonalizeTangent = true;
 
         //Performance
         bool GPUEnable = true;
@@ -356,6 +411,11 @@ namespace Mus {
         std::uint32_t DiskCacheLimitMB = 500;
         bool ClearDiskCache = true;
         float DiskCacheHashPrecision = 1 << 9;
+        std::uint32_t TopologyCacheSize = 8;
+        float FaceDataRebuildThreshold = 0.5f;
+        std::uint32_t GeometryDataPoolSize = 256; // MB
+        bool TriangleReorder = true; // faces in vertex order for the normal passes, baked in uv morton order
+        std::uint32_t SourceTextureCacheSize = 256; // MB
 
         //RealtimeDetect
         bool RealtimeDetect = true;
@@ -16,6 +16,7 @@ namespace Mus {
             bool hasTangents = false;
             bool hasBitangents = false;
             std::uint32_t vertexCount = 0;
+            void SetDesc(const RE::BSGraphics::VertexDesc& a_desc);
         };
         struct ObjectInfo {
             GeometryInfo info;
@@ -41,17 +42,36 @@ namespace Mus {
             std::vector<RE::NiPoint3> dynamicBlockData1;      // without expression
             std::vector<DirectX::XMFLOAT4> dynamicBlockData2; // with expression
             std::vector<std::uint16_t> indicesBlockData;
+
+            // blocks read in place from a mapped snapshot instead of the vectors above, blockSource keeps the mapping alive
+            std::shared_ptr<const void> blockSource;
+            std::span<const std::uint8_t> geometryBlockView;
+            std::span<const RE::NiPoint3> dynamicBlockView1;
+            std::span<const DirectX::XMFLOAT4> dynamicBlockView2;
+            std::span<const std::uint16_t> indicesBlockView;
+            std::span<const std::uint8_t> GetGeometryBlock() const { return blockSource ? geometryBlockView : std::span<const std::uint8_t>(geometryBlockData); }
+            std::span<const RE::NiPoint3> GetDynamicBlock1() const { return blockSource ? dynamicBlockView1 : std::span<const RE::NiPoint3>(dynamicBlockData1); }
+            std::span<const DirectX::XMFLOAT4> GetDynamicBlock2() const { return blockSource ? dynamicBlockView2 : std::span<const DirectX::XMFLOAT4>(dynamicBlockData2); }
+            std::span<const std::uint16_t> GetIndicesBlock() const { return blockSource ? indicesBlockView : std::span<const std::uint16_t>(indicesBlockData); }
         };
         static RE::BSFaceGenBaseMorphExtraData* GetMorphExtraData(RE::BSGeometry* a_geometry);
         static std::uint32_t GetVertexCount(RE::BSGeometry* a_geometry);
+        static std::uint64_t GetLayoutHash(RE::BSGeometry* a_geometry); // name and vertex count, sum them for a set of geometries
+
+        // reset for the next update, every buffer keeps its capacity
+        void Clear();
+        std::size_t GetMemoryUsage() const;
+        std::uint64_t poolLayoutHash = 0; // key in GeometryDataPool
 
         bool GetGeometryInfo(RE::BSGeometry* a_geo, GeometryInfo& info);
         bool CopyGeometryData(RE::BSGeometry* a_geo);
+        void AddGeometry(RE::BSGeometry* a_geo, ObjectInfo&& a_objInfo);
         void GetGeometryData();
         void PreProcessing(bool weldAccuracy);
         void CreateFaceData();
+        void UpdateFaceData(std::span<const std::uint8_t> movedVertices); // only faces touching moved vertices
         void RecalculateNormals(float a_smoothDegree);
-        void Subdivision(std::uint32_t a_subCount, std::uint32_t a_triThreshold, float a_strength, std::uint32_t a_smoothCount, bool weldAccuracy);
+        void Subdivision(std::uint32_t a_subCount, std::uint32_t a_triThreshold, bool a_adaptive, float a_texelThreshold, float a_angleThreshold, float a_strength, std::uint32_t a_smoothCount, bool weldAccuracy);
         void VertexSmooth(float a_strength, std::uint32_t a_smoothCount);
         void VertexSmoothByAngle(float a_smoothThreshold1, float a_smoothThreshold2, std::uint32_t a_smoothCount);
         void CreateGeometryHash(float a_precision);
@@ -66,18 +86,71 @@ namespace Mus {
         std::vector<DirectX::XMFLOAT3> tangents;
         std::vector<DirectX::XMFLOAT3> bitangents;
         std::vector<std::uint32_t> indices;
+        std::vector<std::uint32_t> bakeOrder; // faces sorted by uv morton code inside each geometry, so bakeOrder[i] is in the same geometry as face i
+        std::vector<std::uint32_t> faceOrder; // face i of indices is face faceOrder[i] of the game geometry, empty if the faces keep the game order
+
+        std::shared_ptr<ScratchArena> arena = std::make_shared<ScratchArena>(); // scratch buffers of this update, a new one on Clear()
+        std::vector<ObjectInfo> spareObjectInfos; // block buffers of the last update, reused by CopyGeometryData
 
         struct GeometriesInfo {
             RE::BSGeometry* geometry; // for ptr compare only
             ObjectInfo objInfo;
             std::uint64_t hash;
+            std::uint32_t bakeWidth = 0, bakeHeight = 0; // the dst size of its bake, 0 for the config size
         };
         std::vector<GeometriesInfo> geometries;
         std::uint32_t mainGeometryIndex = 0;
 
+        struct EdgeMid {
+            std::uint32_t v0, v1;
+            std::uint32_t mv;
+            bool operator<(const EdgeMid& other) const {
+                return mv < other.mv;
+            }
+            std::uint64_t RadixKey() const { return mv; }
+        };
+        struct GeometryRange {
+            std::uint32_t vertexStart = 0;
+            std::uint32_t vertexEnd = 0;
+            std::uint32_t uvStart = 0;
+            std::uint32_t uvEnd = 0;
+            std::uint32_t indicesStart = 0;
+            std::uint32_t indicesEnd = 0;
+        };
+        struct TopologyData {
+            GeometryKernel::AdjacencyList vertexToFaceMap;
+            GeometryKernel::EdgeTable edgeTable;
+            std::vector<std::uint32_t> weldCluster;
+            GeometryKernel::AdjacencyList weldClusters;
+        };
+        struct SubdivisionTopology {
+            std::vector<std::uint32_t> indices;
+            std::vector<DirectX::XMFLOAT2> uvs;
+            std::vector<GeometryRange> ranges;      // per geometry
+            std::vector<std::uint32_t> vertexRemap; // vertex before subdivision -> vertex after subdivision
+            std::vector<EdgeMid> midpoints;         // all in vertices after subdivision
+            TopologyData topology;
+        };
+        // everything in the geometry processing which only depends on the indices and uvs
+        struct TopologyCacheData {
+            TopologyData base;
+            std::vector<SubdivisionTopology> subdivisions;
+            std::vector<std::uint32_t> bakeOrder; // empty if the final faces depend on the vertex positions
+            std::vector<std::uint32_t> faceOrder;
+        };
+        std::uint64_t GetTopologyHash(std::uint32_t a_subCount, std::uint32_t a_triThreshold, bool weldAccuracy) const;
+        float GetBakeTexelArea(std::size_t a_geometryIndex) const; // texels of the whole uv space in the bake of the geometry
+
     private:
         std::shared_ptr<TBB_ThreadPool> tp;
 
+        std::uint64_t topologyHash = 0;
+        std::shared_ptr<const TopologyCacheData> cachedTopology = nullptr; // hit, reuse it
+        std::shared_ptr<TopologyCacheData> newTopology = nullptr;          // miss, record into it
+        void BuildTopology(bool weldAccuracy);
+        void SaveTopology(TopologyData& data) const;
+        void LoadTopology(const TopologyData& data);
+
         inline float SmoothStepRange(float x, float A, float B) const {
             if (x > A)
                 return 0.0f;
@@ -87,19 +160,6 @@ namespace Mus {
             return std::clamp(t * t * (3.0f - 2.0f * t), 0.0f, 1.0f);
         }
 
-        struct Edge {
-            std::uint32_t v0, v1;
-            std::size_t operator()() const {
-                return (static_cast<std::size_t>(v0) << 32) | v1;
-            }
-            bool operator<(const Edge& other) const {
-                return (*this)() < other();
-            }
-            bool operator==(const Edge& other) const {
-                return (*this)() == other();
-            }
-        };
-
         struct PositionKey {
             std::int32_t x, y, z;
             std::uint64_t operator()() const {
@@ -116,6 +176,7 @@ namespace Mus {
             bool operator<(const PosEntry& other) const {
                 return key != other.key ? key < other.key : index < other.index;
             }
+            std::uint64_t RadixKey() const { return key; } // equal keys keep their input order
             PosEntry() {};
             PosEntry(const PositionKey& a_key, std::uint32_t a_index) : key(a_key()), index(a_index) {}
         };
@@ -174,79 +235,74 @@ namespace Mus {
             return {p.x, p.y, p.z};
         }
 
-        std::vector<std::vector<std::uint32_t>> weldedVertices;
+        std::vector<std::uint32_t> weldCluster;       // weld cluster id of each vertex
+        GeometryKernel::AdjacencyList weldClusters;    // weld cluster id -> welded vertices, including itself
+        inline std::span<const std::uint32_t> GetWeldedVertices(const std::uint32_t vi) const {
+            return weldClusters[weldCluster[vi]];
+        }
         inline bool IsWeldedVertex(const std::uint32_t vi, const std::uint32_t tv) const {
-            return std::find(weldedVertices[vi].cbegin(), weldedVertices[vi].cend(), tv) != weldedVertices[vi].end();
+            return weldCluster[vi] == weldCluster[tv];
         }
-        inline void AddWeldVertices(const std::vector<PosEntry>& entry) {
+        inline void AddWeldVertices(const std::vector<PosEntry>& entry, GeometryKernel::DisjointSet& weldSet) {
             if (entry.empty())
                 return;
             std::size_t begin = 0;
             for (std::size_t end = 1; end <= entry.size(); end++) {
                 if (end != entry.size() && entry[end].key == entry[begin].key)
                     continue;
-                for (std::size_t i = begin; i < end; i++) {
-                    const std::uint32_t v0 = entry[i].index;
-                    weldedVertices[v0].reserve(weldedVertices[v0].size() + end - begin);
-                    for (std::size_t j = begin; j < end; j++) {
-                        const std::uint32_t v1 = entry[j].index;
-                        weldedVertices[v0].push_back(v1);
-                    }
+                for (std::size_t i = begin + 1; i < end; i++) {
+                    weldSet.Union(entry[begin].index, entry[i].index);
                 }
                 begin = end;
             }
         }
-        inline void AddWeldBoundaryVertices(const std::vector<PosEntry>& entry) {
+        inline void AddWeldBoundaryVertices(const std::vector<PosEntry>& entry, GeometryKernel::DisjointSet& weldSet) {
             if (entry.empty())
                 return;
+            // only the cross-geometry pairs of a bucket, the kernel keeps them from chaining vertices of one geometry together
+            std::vector<GeometryKernel::WeldPair> pairs;
             std::size_t begin = 0;
             for (std::size_t end = 1; end <= entry.size(); end++) {
                 if (end != entry.size() && entry[end].key == entry[begin].key)
                     continue;
                 for (std::size_t i = begin; i < end; i++) {
-                    const std::uint32_t v0 = entry[i].index;
-                    weldedVertices[v0].reserve(weldedVertices[v0].size() + end - begin);
-                    for (std::size_t j = begin; j < end; j++) {
-                        const std::uint32_t v1 = entry[j].index;
-                        if (IsSameGeometry(v0, v1))
+                    for (std::size_t j = i + 1; j < end; j++) {
+                        if (entry[i].index == entry[j].index || IsSameGeometry(entry[i].index, entry[j].index))
                             continue;
-                        weldedVertices[v0].push_back(v1);
+                        pairs.push_back({entry[i].index, entry[j].index});
                     }
                 }
                 begin = end;
             }
+            GeometryKernel::WeldSeamPairs(pairs, vertices, vertexGeometry, weldSet);
         }
+        void BuildWeldClusters(GeometryKernel::DisjointSet& weldSet);
 
-        struct FaceNormal {
-            std::uint32_t v0, v1, v2;
-            DirectX::XMFLOAT3 normal;
-        };
-        std::vector<FaceNormal> faceNormals;
-        std::vector<tbb::concurrent_vector<std::uint32_t>> vertexToFaceMap;
+        // SoA working set for the face / vertex kernels
+        GeometryKernel::Float3Planes vertexPlanes;
+        GeometryKernel::Float2Planes uvPlanes;
+        GeometryKernel::FacePlanes facePlanes;
+        void UpdateFacePlanes();
 
-        struct FaceTangent {
-            std::uint32_t v0, v1, v2;
-            DirectX::XMFLOAT3 tangent;
-            DirectX::XMFLOAT3 bitangent;
-        };
-        std::vector<FaceTangent> faceTangents;
+        GeometryKernel::Float3Planes faceNormals;
+        GeometryKernel::Float3Planes faceTangents;
+        GeometryKernel::Float3Planes faceBitangents;
+        GeometryKernel::AdjacencyList vertexToFaceMap;
+        GeometryKernel::EdgeTable edgeTable;
+        GeometryKernel::AdjacencyList oneRing; // neighbors over all welded links, for VertexSmooth
+        void BuildOneRing();
+        void RecalculateMikkTSpaceTangents();
 
+        static constexpr std::uint16_t invalidGeometry = UINT16_MAX;
+        std::vector<std::uint16_t> vertexGeometry; // index in geometries of each vertex, rebuilt whenever the vertex ranges change
+        void BuildVertexGeometry();
+        void BuildFaceOrder();
+        void ApplyFaceOrder();
+        void BuildBakeOrder(bool a_cacheable);
         inline bool IsSameGeometry(const std::uint32_t v0, const std::uint32_t v1) const {
-            const auto it = std::find_if(geometries.cbegin(), geometries.cend(), [&](const GeometriesInfo& geoInfo) {
-                return geoInfo.objInfo.vertexStart <= v0 && geoInfo.objInfo.vertexEnd > v0;
-            });
-            if (it == geometries.cend())
-                return false;
-            return it->objInfo.vertexStart <= v1 && it->objInfo.vertexEnd > v1;
+            return vertexGeometry[v0] != invalidGeometry && vertexGeometry[v0] == vertexGeometry[v1];
         };
 
-        struct EdgeMid {
-            std::uint32_t v0, v1;
-            std::uint32_t mv;
-            bool operator<(const EdgeMid& other) const {
-                return mv < other.mv;
-            }
-        };
         inline bool IsWeldedEdge(const EdgeMid& e0, const EdgeMid& e1) const {
             return IsWeldedVertex(e0.v0, e1.v0) && IsWeldedVertex(e0.v1, e1.v1);
         }
@@ -262,51 +318,118 @@ namespace Mus {
     };
     typedef std::shared_ptr<GeometryData> GeometryDataPtr;
 
+    class TopologyCache {
+    public:
+        [[nodiscard]] static TopologyCache& GetSingleton() {
+            static TopologyCache instance;
+            return instance;
+        }
+
+        typedef std::shared_ptr<const GeometryData::TopologyCacheData> TopologyCacheDataPtr;
+        TopologyCacheDataPtr Get(std::uint64_t a_hash);
+        void Insert(std::uint64_t a_hash, TopologyCacheDataPtr a_data);
+        void Clear();
+
+    private:
+        std::mutex lock;
+        std::list<std::uint64_t> lru; // front is the most recently used
+        struct CacheEntry {
+            TopologyCacheDataPtr data;
+            std::list<std::uint64_t>::iterator lruIt;
+        };
+        std::unordered_map<std::uint64_t, CacheEntry> map;
+    };
+
+    // geometry data of finished updates, one per actor and geometry layout
+    // the next update of the same actor and layout starts with the old capacity instead of empty vectors
+    class GeometryDataPool {
+    public:
+        [[nodiscard]] static GeometryDataPool& GetSingleton() {
+            static GeometryDataPool instance;
+            return instance;
+        }
+
+        GeometryDataPtr Acquire(RE::FormID a_actorID, std::uint64_t a_layoutHash);
+        // the update of a_data must be done, other holders must not touch it anymore
+        void Release(RE::FormID a_actorID, GeometryDataPtr a_data);
+        void Clear();
+
+    private:
+        std::mutex lock;
+        std::size_t totalBytes = 0;
+        typedef std::pair<RE::FormID, std::uint64_t> PoolKey;
+        struct PoolKeyHash {
+            std::size_t operator()(const PoolKey& key) const {
+                return std::hash<std::uint64_t>()(key.second ^ (static_cast<std::uint64_t>(key.first) * 0x9E3779B97F4A7C15ull));
+            }
+        };
+        std::list<PoolKey> lru; // front is the most recently used
+        struct PoolEntry {
+            GeometryDataPtr data;
+            std::size_t bytes;
+            std::list<PoolKey>::iterator lruIt;
+        };
+        std::unordered_map<PoolKey, PoolEntry, PoolKeyHash> map;
+    };
+
+    template <typename T>
+    concept RadixSortable = requires(const T& t) {
+        { t.RadixKey() } -> std::convertible_to<std::uint64_t>;
+    };
+
     template <typename V, typename TP>
     void parallel_sort(V& v, TP* tp) {
         if (v.empty() || !tp)
             return;
-        const std::size_t max = v.size();
-        if (max < 4096)
+        if constexpr (RadixSortable<typename V::value_type> && std::is_same_v<TP, TBB_ThreadPool>)
         {
-            std::sort(v.begin(), v.end());
+            parallel_radix_sort(v, [](const typename V::value_type& e) { return e.RadixKey(); }, tp);
             return;
         }
-
-        const std::size_t threads = tp->GetThreadSize() * std::min(4ull, std::max(1ull, max / 4096));
-        const std::size_t sub = std::max(1ull, std::min(max, threads));
-        const std::size_t unit = (max + sub - 1) / sub;
+        else
         {
-            std::vector<std::future<void>> processes;
-            for (std::size_t t = 0; t < sub; t++) {
-                const std::size_t begin = t * unit;
-                const std::size_t end = std::min(begin + unit, max);
-                processes.push_back(tp->submitAsync([&, t, begin, end]() {
-                    std::sort(v.begin() + begin, v.begin() + end);
-                }));
-            }
-            for (auto& process : processes) {
-                process.get();
+            const std::size_t max = v.size();
+            if (max < 4096)
+            {
+                std::sort(v.begin(), v.end());
+                return;
             }
-        }
 
-        std::size_t current_unit = unit;
-        while (current_unit < max) {
-            std::vector<std::future<void>> processes;
-            for (std::size_t i = 0; i < max; i += current_unit * 2) {
-                const std::size_t begin = i;
-                const std::size_t mid = i + current_unit;
-                const std::size_t end = std::min(mid + current_unit, max);
-                if (mid >= max)
-                    continue;
-                processes.push_back(tp->submitAsync([&v, begin, mid, end]() {
-                    std::inplace_merge(v.begin() + begin, v.begin() + mid, v.begin() + end);
-                }));
+            const std::size_t threads = tp->GetThreadSize() * std::min(4ull, std::max(1ull, max / 4096));
+            const std::size_t sub = std::max(1ull, std::min(max, threads));
+            const std::size_t unit = (max + sub - 1) / sub;
+            {
+                std::vector<std::future<void>> processes;
+                for (std::size_t t = 0; t < sub; t++) {
+                    const std::size_t begin = t * unit;
+                    const std::size_t end = std::min(begin + unit, max);
+                    processes.push_back(tp->submitAsync([&, t, begin, end]() {
+                        std::sort(v.begin() + begin, v.begin() + end);
+                    }));
+                }
+                for (auto& process : processes) {
+                    process.get();
+                }
             }
-            for (auto& process : processes) {
-                process.get();
+
+            std::size_t current_unit = unit;
+            while (current_unit < max) {
+                std::vector<std::future<void>> processes;
+                for (std::size_t i = 0; i < max; i += current_unit * 2) {
+                    const std::size_t begin = i;
+                    const std::size_t mid = i + current_unit;
+                    const std::size_t end = std::min(mid + current_unit, max);
+                    if (mid >= max)
+                        continue;
+                    processes.push_back(tp->submitAsync([&v, begin, mid, end]() {
+                        std::inplace_merge(v.begin() + begin, v.begin() + mid, v.begin() + end);
+                    }));
+                }
+                for (auto& process : processes) {
+                    process.get();
+                }
+                current_unit *= 2;
             }
-            current_unit *= 2;
         }
     }
 } // namespace Mus
\ No newline at end of file
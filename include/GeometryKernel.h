@@ -0,0 +1,331 @@
+#pragma once
+
+namespace Mus {
+    template <typename T, std::size_t Alignment = 32>
+    struct AlignedAllocator {
+        using value_type = T;
+        template <typename U>
+        struct rebind {
+            using other = AlignedAllocator<U, Alignment>;
+        };
+
+        AlignedAllocator() noexcept = default;
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+        T* allocate(std::size_t n) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+        }
+        void deallocate(T* p, std::size_t) noexcept {
+            ::operator delete(p, std::align_val_t(Alignment));
+        }
+        template <typename U>
+        bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+    };
+    template <typename T>
+    using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+    // stable LSD radix sort on a 64-bit key, 11 bits per pass, passes whose digit never changes are skipped
+    template <typename T, typename KeyFunc>
+    void parallel_radix_sort(std::vector<T>& v, KeyFunc&& getKey, TBB_ThreadPool* tp) {
+        const std::size_t max = v.size();
+        if (max < 4096 || !tp)
+        {
+            std::stable_sort(v.begin(), v.end(), [&](const T& a, const T& b) {
+                return getKey(a) < getKey(b);
+            });
+            return;
+        }
+
+        constexpr std::uint32_t radixBits = 11;
+        constexpr std::size_t radix = std::size_t(1) << radixBits;
+        const std::size_t threads = std::max(1, tp->GetThreadSize());
+        const std::size_t unit = std::max<std::size_t>(4096, (max + threads * 4 - 1) / (threads * 4));
+        const std::size_t blocks = (max + unit - 1) / unit;
+
+        std::vector<std::uint64_t> blockDiff(blocks, 0);
+        const std::uint64_t firstKey = getKey(v[0]);
+        tp->Execute([&] {
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>(0, blocks),
+                [&](const tbb::blocked_range<std::size_t>& r) {
+                    for (std::size_t b = r.begin(); b != r.end(); ++b)
+                    {
+                        const std::size_t end = std::min(b * unit + unit, max);
+                        std::uint64_t diff = 0;
+                        for (std::size_t i = b * unit; i < end; i++)
+                        {
+                            diff |= getKey(v[i]) ^ firstKey;
+                        }
+                        blockDiff[b] = diff;
+                    }
+                },
+                tbb::auto_partitioner()
+            );
+        });
+        std::uint64_t diff = 0;
+        for (const auto& d : blockDiff)
+        {
+            diff |= d;
+        }
+        if (diff == 0)
+            return;
+
+        std::vector<T> temp(max);
+        std::vector<std::uint32_t> histogram(blocks * radix);
+        T* src = v.data();
+        T* dst = temp.data();
+        for (std::uint32_t shift = 0; shift < 64; shift += radixBits)
+        {
+            if (((diff >> shift) & (radix - 1)) == 0)
+                continue;
+
+            tp->Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, blocks),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                        for (std::size_t b = r.begin(); b != r.end(); ++b)
+                        {
+                            std::uint32_t* hist = &histogram[b * radix];
+                            std::fill(hist, hist + radix, 0);
+                            const std::size_t end = std::min(b * unit + unit, max);
+                            for (std::size_t i = b * unit; i < end; i++)
+                            {
+                                hist[(getKey(src[i]) >> shift) & (radix - 1)]++;
+                            }
+                        }
+                    },
+                    tbb::auto_partitioner()
+                );
+            });
+
+            std::uint32_t sum = 0;
+            for (std::size_t d = 0; d < radix; d++)
+            {
+                for (std::size_t b = 0; b < blocks; b++)
+                {
+                    const std::uint32_t count = histogram[b * radix + d];
+                    histogram[b * radix + d] = sum;
+                    sum += count;
+                }
+            }
+
+            tp->Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, blocks),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                        for (std::size_t b = r.begin(); b != r.end(); ++b)
+                        {
+                            std::uint32_t* hist = &histogram[b * radix];
+                            const std::size_t end = std::min(b * unit + unit, max);
+                            for (std::size_t i = b * unit; i < end; i++)
+                            {
+                                dst[hist[(getKey(src[i]) >> shift) & (radix - 1)]++] = src[i];
+                            }
+                        }
+                    },
+                    tbb::auto_partitioner()
+                );
+            });
+            std::swap(src, dst);
+        }
+        if (src != v.data())
+            v.swap(temp);
+    }
+
+    namespace GeometryKernel {
+        // every plane is padded to a multiple of the widest kernel (AVX2, 8 lanes)
+        constexpr std::size_t laneWidth = 8;
+        inline std::size_t PaddedSize(std::size_t n) { return (n + laneWidth - 1) & ~(laneWidth - 1); }
+        inline std::size_t BlockCount(std::size_t n) { return PaddedSize(n) / laneWidth; }
+
+        // compressed sparse row list, items of key i are items[offsets[i]..offsets[i + 1])
+        struct AdjacencyList {
+            std::vector<std::uint32_t> offsets;
+            std::vector<std::uint32_t> items;
+
+            // item n is (n / divisor) and goes to the list of keys[n], keys out of range are skipped
+            // each list is sorted, so the result does not depend on the thread scheduling
+            void Build(std::size_t keyCount, std::span<const std::uint32_t> keys, std::uint32_t divisor, TBB_ThreadPool* tp);
+            void Clear();
+
+            inline std::size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+            inline bool empty() const { return items.empty(); }
+            inline std::span<const std::uint32_t> operator[](std::size_t i) const {
+                return {items.data() + offsets[i], items.data() + offsets[i + 1]};
+            }
+        };
+
+        // union-find with the smallest index as root, so clusters come out in a fixed order
+        struct DisjointSet {
+            std::vector<std::uint32_t> parent;
+
+            void Reset(std::size_t n);
+            inline std::uint32_t Find(std::uint32_t x) {
+                while (parent[x] != x)
+                {
+                    parent[x] = parent[parent[x]];
+                    x = parent[x];
+                }
+                return x;
+            }
+            inline void Union(std::uint32_t a, std::uint32_t b) {
+                a = Find(a);
+                b = Find(b);
+                if (a == b)
+                    return;
+                if (a < b)
+                    parent[b] = a;
+                else
+                    parent[a] = b;
+            }
+            // clusterOf[i] = cluster id of i, ids are numbered in order of their smallest member
+            std::uint32_t Flatten(std::vector<std::uint32_t>& clusterOf);
+        };
+
+        // two boundary vertices of different geometries under the same boundary key
+        struct WeldPair {
+            std::uint32_t v0, v1;
+        };
+        // seam weld on top of the position clusters already in weldSet, the closest pairs first
+        // a pair is skipped if its clusters hold different position clusters of one geometry (UINT16_MAX is no geometry),
+        // so the vertices of one geometry are never welded to each other through a seam or a chain of keys
+        // pairs is sorted and deduplicated in place
+        void WeldSeamPairs(std::vector<WeldPair>& pairs, const std::vector<DirectX::XMFLOAT3>& vertices,
+                           const std::vector<std::uint16_t>& vertexGeometry, DisjointSet& weldSet);
+
+        // undirected edge table, edge ids are ordered by (v0, v1) so every geometry owns a contiguous range
+        struct EdgeTable {
+            static constexpr std::uint32_t invalid = UINT32_MAX;
+
+            std::vector<std::uint32_t> v0, v1;        // v0 <= v1
+            std::vector<std::uint32_t> faceCount;     // faces sharing the edge, 1 = boundary edge
+            std::vector<std::uint32_t> firstHalfEdge; // smallest face * 3 + corner using the edge
+            std::vector<std::uint32_t> halfEdges;     // face * 3 + corner -> edge, corners are (i0,i1) (i1,i2) (i0,i2)
+            std::vector<std::uint8_t> boundaryVertex;
+            AdjacencyList vertexEdges;
+
+            // faces with an index out of range get invalid half edges
+            void Build(const std::vector<std::uint32_t>& indices, std::size_t vertexCount, TBB_ThreadPool* tp);
+            void Clear();
+
+            inline std::size_t size() const { return v0.size(); }
+            inline bool empty() const { return v0.empty(); }
+            inline std::uint32_t Edge(std::size_t face, std::uint32_t corner) const { return halfEdges[face * 3 + corner]; }
+            inline bool IsBoundaryEdge(std::uint32_t e) const { return faceCount[e] == 1; }
+            inline bool IsBoundaryVertex(std::uint32_t v) const { return boundaryVertex[v] != 0; }
+            inline std::uint32_t Other(std::uint32_t e, std::uint32_t v) const { return v0[e] == v ? v1[e] : v0[e]; }
+        };
+
+        struct Float3Planes {
+            AlignedVector<float> x, y, z;
+            std::size_t count = 0;
+
+            void Resize(std::size_t n);
+            void Clear();
+            void Load(const std::vector<DirectX::XMFLOAT3>& src, TBB_ThreadPool* tp);
+            void Store(std::vector<DirectX::XMFLOAT3>& dst, TBB_ThreadPool* tp) const;
+
+            inline DirectX::XMVECTOR Get(std::size_t i) const {
+                return DirectX::XMVectorSet(x[i], y[i], z[i], 0.0f);
+            }
+            inline void Set(std::size_t i, DirectX::FXMVECTOR v) {
+                DirectX::XMFLOAT3 f;
+                DirectX::XMStoreFloat3(&f, v);
+                x[i] = f.x;
+                y[i] = f.y;
+                z[i] = f.z;
+            }
+        };
+
+        struct Float2Planes {
+            AlignedVector<float> x, y;
+            std::size_t count = 0;
+
+            void Resize(std::size_t n);
+            void Clear();
+            void Load(const std::vector<DirectX::XMFLOAT2>& src, TBB_ThreadPool* tp);
+        };
+
+        struct FacePlanes {
+            AlignedVector<std::uint32_t> i0, i1, i2;
+            std::size_t count = 0;
+
+            void Resize(std::size_t n);
+            void Clear();
+            // invalid faces are collapsed to vertex 0, so the kernels never gather out of range
+            void Load(const std::vector<std::uint32_t>& indices, std::size_t vertexCount, TBB_ThreadPool* tp);
+        };
+
+        // decoders for the part of the skyrim vertex block we read, position(float3 + 4 bytes) and uv(half2 with the integer part removed)
+        // decoders write positions only with vertexFormatPosition and uvs only with vertexFormatUV
+        enum VertexFormat : std::uint32_t {
+            vertexFormatPosition = 1 << 0,
+            vertexFormatUV = 1 << 1,
+            vertexFormatTotal = 1 << 2
+        };
+        using VertexDecoder = void (*)(const std::uint8_t* blocks, std::uint32_t vertexSize, std::size_t count,
+                                       DirectX::XMFLOAT3* positions, DirectX::XMFLOAT2* uvs);
+        VertexDecoder GetVertexDecoder(std::uint32_t format);
+
+        // 16 bits per axis, the uv is clamped to [0, 1]
+        inline std::uint32_t MortonCode(float u, float v) {
+            auto spread = [](std::uint32_t x) {
+                x = (x | (x << 8)) & 0x00FF00FF;
+                x = (x | (x << 4)) & 0x0F0F0F0F;
+                x = (x | (x << 2)) & 0x33333333;
+                x = (x | (x << 1)) & 0x55555555;
+                return x;
+            };
+            const std::uint32_t x = static_cast<std::uint32_t>((u > 0.0f ? std::min(u, 1.0f) : 0.0f) * 65535.0f); // nan to 0
+            const std::uint32_t y = static_cast<std::uint32_t>((v > 0.0f ? std::min(v, 1.0f) : 0.0f) * 65535.0f);
+            return spread(x) | (spread(y) << 1);
+        }
+
+        // faces [faceBegin, faceEnd) sorted by a key per face, order[faceBegin, faceEnd) gets the face ids and equal keys keep their order
+        // order has to hold faceEnd items, faces with an index out of range get key 0
+        // uv order : morton code of the uv centroid, the bake walks the texture in tiles
+        void BuildUVOrder(const std::vector<std::uint32_t>& indices, const std::vector<DirectX::XMFLOAT2>& uvs,
+                          std::size_t faceBegin, std::size_t faceEnd, std::vector<std::uint32_t>& order, TBB_ThreadPool* tp);
+        // vertex order : smallest vertex index, faces sharing a vertex end up next to each other
+        void BuildVertexOrder(const std::vector<std::uint32_t>& indices, std::size_t vertexCount,
+                              std::size_t faceBegin, std::size_t faceEnd, std::vector<std::uint32_t>& order, TBB_ThreadPool* tp);
+
+        // a * bary.x + b * bary.y + c * bary.z, normalized
+        DirectX::XMVECTOR NlerpVector(DirectX::FXMVECTOR a, DirectX::FXMVECTOR b, DirectX::FXMVECTOR c, const DirectX::XMFLOAT3& bary);
+        // rotates a towards b by t of the angle between them, both normalized
+        DirectX::XMVECTOR SlerpVector(DirectX::FXMVECTOR a, DirectX::FXMVECTOR b, float t);
+
+        // one laplacian step over vertices [begin, end) as a sparse matrix-vector product
+        // dst[i] = src[i] + (mean of src[ring[i]] - src[i]) * weight, vertices without a ring are copied
+        void LaplacianSmooth(const AdjacencyList& ring, const std::vector<DirectX::XMFLOAT3>& src, float weight,
+                             std::size_t begin, std::size_t end, std::vector<DirectX::XMFLOAT3>& dst);
+
+        // face normal(normalized), tangent and bitangent for face blocks [blockBegin, blockEnd)
+        void ComputeFaceData(const Float3Planes& positions, const Float2Planes& uvs, const FacePlanes& faces,
+                             std::size_t blockBegin, std::size_t blockEnd,
+                             Float3Planes& faceNormals, Float3Planes& faceTangents, Float3Planes& faceBitangents);
+
+        // normalize the accumulated n/t/b sums and orthogonalize t/b against n for vertex blocks [blockBegin, blockEnd)
+        // lanes with valid == 0 or a degenerated sum keep the value already in the output planes
+        void FinalizeVertexBasis(const Float3Planes& nSum, const Float3Planes& tSum, const Float3Planes& bSum, const AlignedVector<std::uint32_t>& valid,
+                                 std::size_t blockBegin, std::size_t blockEnd,
+                                 Float3Planes& normals, Float3Planes& tangents, Float3Planes& bitangents);
+
+        // covered pixels of up to 8 pixels from (x, y) in one row, bit i is the pixel x + i
+        // u, v, w are the weights of a, b, c at the pixel center and sum to 1
+        struct RasterSpan {
+            std::int32_t x, y;
+            std::uint32_t mask;
+            alignas(32) float u[laneWidth];
+            alignas(32) float v[laneWidth];
+            alignas(32) float w[laneWidth];
+        };
+        // pixels of [minX, maxX) x [minY, maxY) whose center is inside the triangle or on its edge, either winding
+        // the rect is walked in 8x8 blocks on the pixel grid, blocks fully outside one edge are skipped without a pixel test
+        // spans is cleared first, a degenerated triangle gives no span
+        void RasterizeTriangle(const DirectX::XMINT2& a, const DirectX::XMINT2& b, const DirectX::XMINT2& c,
+                               std::int32_t minX, std::int32_t minY, std::int32_t maxX, std::int32_t maxY,
+                               std::vector<RasterSpan>& spans);
+    }
+}
@@ -19,6 +19,21 @@ namespace Mus{
 		bool GetResource(std::uint64_t a_hash, TextureResourcePtr& a_resource, bool& isDiskCache);
 		void ClearMemory();
 
+		// bakes in flight, an update waits for the same bake of another update and then finds its result in the store
+		class BakeGuard {
+		public:
+			BakeGuard() = default;
+			~BakeGuard() { End(); };
+			BakeGuard(const BakeGuard&) = delete;
+			BakeGuard& operator=(const BakeGuard&) = delete;
+
+			bool Acquire(std::uint64_t a_key); // owns the key, waits first while another update owns it. true if it has waited
+			void End(std::uint64_t a_key); // wakes the waiting updates of the key
+			void End(); // wakes the waiting updates, whether the bake has succeeded or not
+		private:
+			std::vector<std::uint64_t> keys;
+		};
+
 		void AddHashPair(std::uint64_t a_hash, std::uint64_t b_hash);
 		bool IsPairHashes(std::uint64_t a_hash, std::uint64_t b_hash);
 		void InitHashPair(std::uint64_t a_hash);
@@ -93,5 +108,15 @@ namespace Mus{
 		std::mutex hashPairsLock;
 		typedef std::unordered_set<std::uint64_t> HashPair;
 		std::vector<HashPair> hashPairs;
+
+		static constexpr std::chrono::seconds bakeWaitTimeout = std::chrono::seconds(30);
+		std::shared_future<void> AcquireOrWait(std::uint64_t a_key); // registers the bake and returns an empty future, or returns the future of the bake in flight
+		void EndBake(std::uint64_t a_key);
+		std::mutex bakeLock;
+		struct Bake {
+			std::promise<void> done;
+			std::shared_future<void> future = done.get_future().share();
+		};
+		std::unordered_map<std::uint64_t, std::unique_ptr<Bake>> bakes;
 	};
 }
\ No newline at end of file
@@ -49,9 +49,12 @@ namespace Mus {
 		}
 
 		bool Init();
-		bool CreateGeometryResourceData(RE::FormID a_actorID, GeometryDataPtr a_data);
+		bool CreateGeometryResourceData(RE::FormID a_actorID, GeometryDataPtr a_data, const UpdateSet& a_updateSet);
 
 		void ClearGeometryResourceData();
+		void RemoveGeometryResourceData(RE::FormID a_actorID);
+
+		static constexpr RE::FormID replayActorID = 0xFFFFFFFF; // snapshot replays, never an actor in game. its results are not stored
 
 		struct NormalMapResult {
 			bool existResource = false;
@@ -99,7 +102,8 @@ namespace Mus {
 
 		bool LoadTexture(ID3D11Device* device, ID3D11DeviceContext* context, const std::string& filePath, D3D11_TEXTURE2D_DESC& texDesc, D3D11_SHADER_RESOURCE_VIEW_DESC& srvDesc, Microsoft::WRL::ComPtr<ID3D11Texture2D>& texOutput, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>& srvOutput);
 		bool LoadTexture(ID3D11Device* device, ID3D11DeviceContext* context, const std::string& filePath, D3D11_TEXTURE2D_DESC& texDesc, Microsoft::WRL::ComPtr<ID3D11Texture2D>& texOutput, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>& srvOutput);
-		bool LoadTextureCPU(ID3D11Device* device, ID3D11DeviceContext* context, const std::string& filePath, D3D11_TEXTURE2D_DESC& texDesc, Microsoft::WRL::ComPtr<ID3D11Texture2D>& output);
+		// RGBA8 through TextureCPUCache, the smallest mip which still covers minWidth x minHeight (0 for the top mip)
+		bool LoadTextureCPU(ID3D11Device* device, ID3D11DeviceContext* context, const std::string& filePath, UINT minWidth, UINT minHeight, Shader::TextureCPUCache::ImagePtr& output);
 
 		bool isValidGPU[2] = {false, false};
 
@@ -117,6 +121,7 @@ namespace Mus {
 			RE::BSGeometry* geometry;
 			std::string textureName;
 			std::clock_t time = -1;
+			std::shared_ptr<ScratchArena> arena = nullptr; // of the update that baked it, kept alive here past the next GeometryData::Clear()
 
 			std::shared_ptr<Shader::ShaderLocker> sl;
 
@@ -200,7 +205,12 @@ namespace Mus {
             UINT tangentZCorrection;
             float detailStrength;
             UINT vertexEnd;
+            UINT nlerp;
+
+            UINT orthogonalizeTangent;
             UINT padding1;
+            UINT padding2;
+            UINT padding3;
         };
         static_assert(sizeof(UpdateNormalMapBufferData) % 16 == 0, "Constant buffer must be 16-byte aligned.");
         Microsoft::WRL::ComPtr<ID3D11Buffer> updateNormalMapBuffer[2] = {nullptr, nullptr};
@@ -390,10 +400,8 @@ namespace Mus {
         };
 
 		bool IsDetailNormalMap(const std::string& a_normalMapPath);
-        void LoadCacheResource(RE::FormID a_actorID, GeometryDataPtr a_data, UpdateSet& a_updateSet, MergedTextureGeometries& mergedTextureGeometries, ResourceDatas& resourceDatas, UpdateResult& results);
+        void LoadCacheResource(RE::FormID a_actorID, GeometryDataPtr a_data, UpdateSet& a_updateSet, MergedTextureGeometries& mergedTextureGeometries, ResourceDatas& resourceDatas, UpdateResult& results, NormalMapStore::BakeGuard& bakeGuard);
 
-		DirectX::XMVECTOR SlerpVector(const DirectX::XMVECTOR& a, const DirectX::XMVECTOR& b, const float& t);
-		bool ComputeBarycentric(const float& px, const float& py, const DirectX::XMINT2& a, const DirectX::XMINT2& b, const DirectX::XMINT2& c, DirectX::XMFLOAT3& out);
         bool CreateConstBuffer(ID3D11Device* device, UINT byteWidth, Microsoft::WRL::ComPtr<ID3D11Buffer>& bufferOut);
 		bool CreateStructuredBuffer(ID3D11Device* device, const void* data, UINT size, UINT stride, Microsoft::WRL::ComPtr<ID3D11Buffer>& bufferOut, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>& srvOut);
 		bool CopySubresourceRegion(ID3D11Device* device, ID3D11DeviceContext* context, ID3D11Texture2D* dstTexture, ID3D11Texture2D* srcTexture, UINT dstMipMapLevel, UINT srcMipMapLevel);
@@ -401,8 +409,8 @@ namespace Mus {
 		bool CopySubresourceFromBuffer(ID3D11Device* device, ID3D11DeviceContext* context, std::vector<std::uint8_t>& buffer, UINT rowPitch, UINT mipLevel, ID3D11Texture2D* dstTexture);
 		bool CopySubresourceFromBuffer(ID3D11Device* device, ID3D11DeviceContext* context, std::vector<std::vector<std::uint8_t>>& buffer, std::vector<UINT>& rowPitch, ID3D11Texture2D* dstTexture);
 
-		void PostProcessing(ID3D11Device* device, ID3D11DeviceContext* context, ResourceDatas& resourceDatas, UpdateResult& results, MergedTextureGeometries& mergedTextureGeometries);
-        void PostProcessingGPU(ID3D11Device* device, ID3D11DeviceContext* context, ResourceDatas& resourceDatas, UpdateResult& results, MergedTextureGeometries& mergedTextureGeometries);
+		void PostProcessing(RE::FormID a_actorID, ID3D11Device* device, ID3D11DeviceContext* context, ResourceDatas& resourceDatas, UpdateResult& results, MergedTextureGeometries& mergedTextureGeometries);
+        void PostProcessingGPU(RE::FormID a_actorID, ID3D11Device* device, ID3D11DeviceContext* context, ResourceDatas& resourceDatas, UpdateResult& results, MergedTextureGeometries& mergedTextureGeometries);
 
 		bool MergeTexture(ID3D11Device* device, ID3D11DeviceContext* context, TextureResourceDataPtr& rsourceData, ID3D11Texture2D* dstTex, ID3D11Texture2D* srcTex);
         bool MergeTextureGPU(ID3D11Device* device, ID3D11DeviceContext* context, TextureResourceDataPtr& resourceData, ID3D11UnorderedAccessView* dstUAV, ID3D11Texture2D* dstTex, ID3D11ShaderResourceView* srcSRV);
@@ -442,6 +450,7 @@ namespace Mus {
         ResourceDataMap resourceDataMap;
 
 		std::uint64_t GetHash(UpdateTextureSet updateSet, std::uint64_t geoHash);
+		std::uint64_t GetBakeKey(std::uint64_t a_hash) const; // hash + bake settings
 	};
 
 	class WaitForGPU {
@@ -49,6 +49,7 @@
 #include <d3dcompiler.h>
 #pragma comment(lib, "d3dcompiler.lib")
 #include <DirectXMath.h>
+#include <immintrin.h>
 #include <dxcore_interface.h>
 #include <dxcore.h>
 #pragma comment(lib, "dxcore.lib")
@@ -71,6 +72,7 @@
 #include <iterator>
 #include <latch>
 #include <limits>
+#include <list>
 #include <locale>
 #include <map>
 #include <memory>
@@ -148,6 +150,7 @@ using EventResult = RE::BSEventNotifyControl;
 #include <tbb/concurrent_vector.h>
 #include <tbb/concurrent_unordered_map.h>
 #include <tbb/parallel_sort.h>
+#include <tbb/parallel_scan.h>
 #include <tbb/parallel_invoke.h>
 
 #include "bc7e_ispc_avx.h"
@@ -164,6 +167,7 @@ using EventResult = RE::BSEventNotifyControl;
 
 #include "Hook.h"
 #include "ThreadPool.h"
+#include "ScratchArena.h"
 
 #include "Store.h"
 #include "Common.h"
@@ -174,8 +178,11 @@ using EventResult = RE::BSEventNotifyControl;
 
 #include "Condition.h"
 #include "Config.h"
+#include "GeometryKernel.h"
 #include "Geometry.h"
 #include "NormalMapStore.h"
+#include "SnapshotFormat.h"
+#include "Snapshot.h"
 
 #include "ShaderManager.h"
 
@@ -0,0 +1,49 @@
+#pragma once
+
+namespace Mus {
+    // scratch memory of one update, for the flat std::pmr::vector temporaries of the geometry passes and of the bake post processing
+    // the GeometryData member vectors are not on it, they keep their capacity in GeometryDataPool across updates
+    // neither are buffers indexed by the tbb thread index(tpbMap, the GenerateMips colour map), a slot can move to another thread
+    // every thread gets its own unsynchronized pool, so worker threads never meet in the crt heap
+    // small blocks are carved from chunks and recycled inside the pool, big ones go to the heap and back on free
+    // a resource must only be used by the thread that got it from Get(), and everything is freed at once with the arena
+    class ScratchArena {
+    public:
+        ScratchArena(std::size_t a_largestBlock = 1 << 18) : largestBlock(a_largestBlock), id(++nextID) {};
+        ~ScratchArena() {};
+        ScratchArena(const ScratchArena&) = delete;
+        ScratchArena& operator=(const ScratchArena&) = delete;
+
+        std::pmr::memory_resource* Get();
+
+        inline std::size_t GetUsage() const { return upstream.usage.load(); }
+        inline std::size_t GetPeakUsage() const { return upstream.peak.load(); }
+
+    private:
+        // the heap behind all sub arenas, counts what the arena holds right now
+        class CountingResource : public std::pmr::memory_resource {
+        public:
+            std::atomic<std::size_t> usage = 0;
+            std::atomic<std::size_t> peak = 0;
+
+        protected:
+            void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+            void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+        };
+        struct SubArena {
+            std::pmr::unsynchronized_pool_resource pool;
+            SubArena(std::size_t a_largestBlock, std::pmr::memory_resource* a_upstream)
+                : pool(std::pmr::pool_options{0, a_largestBlock}, a_upstream) {}
+        };
+
+        const std::size_t largestBlock;
+        CountingResource upstream;
+        std::mutex lock;
+        std::unordered_map<std::thread::id, std::unique_ptr<SubArena>> subArenas;
+
+        static inline std::atomic<std::uint64_t> nextID = 0;
+        const std::uint64_t id; // never reused, so a thread local lookup never finds a destroyed arena at the same address
+        static constexpr std::size_t threadCacheSize = 4; // arenas remembered per thread
+    };
+}
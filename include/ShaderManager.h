@@ -287,6 +287,13 @@ namespace Mus {
 			bool GetTextureFromFile(ID3D11Device* device, ID3D11DeviceContext* context, std::string filePath, D3D11_TEXTURE2D_DESC& textureDesc, DXGI_FORMAT newFormat, bool cpuReadable, Microsoft::WRL::ComPtr<ID3D11Texture2D>& output);
 			bool GetTextureFromFile(ID3D11Device* device, ID3D11DeviceContext* context, std::string filePath, DXGI_FORMAT newFormat, bool cpuReadable, Microsoft::WRL::ComPtr<ID3D11Texture2D>& output);
 
+			// one mip decoded to newFormat in system memory, the smallest one which still covers minWidth x minHeight (0 for the top mip)
+			// only that mip is copied back from the loaded texture, or decoded from the dds file with fromFile
+			bool GetTextureImage(std::string filePath, DXGI_FORMAT newFormat, UINT minWidth, UINT minHeight, bool fromFile, DirectX::ScratchImage& output);
+			static UINT GetMatchedMipLevel(UINT width, UINT height, UINT mipLevels, UINT minWidth, UINT minHeight);
+			// the top mip size from the dds header only, nothing is decoded
+			bool GetTextureSize(std::string filePath, UINT& width, UINT& height);
+
 			bool UpdateTexture(std::string filePath);
 
 			static RE::NiTexture* CreateTexture(const RE::BSFixedString& name)
@@ -347,9 +354,71 @@ namespace Mus {
 			bool PrintTexture(const std::string& filePath, ID3D11Texture2D* texture);
 		private:
 			bool ConvertD3D11(ID3D11Device* device, DirectX::ScratchImage& image, bool cpuReadable, Microsoft::WRL::ComPtr<ID3D11Resource>& output);
+			bool GetSourceTexture2D(std::string filePath, D3D11_SHADER_RESOURCE_VIEW_DESC& srvDesc, Microsoft::WRL::ComPtr<ID3D11Texture2D>& output); // the texture loaded by the game
+			bool ReadDDSFile(std::string filePath, DirectX::ScratchImage& output);
             bool UpdateNiTexture(const std::string& filePath);
 
 			tbb::concurrent_unordered_map<std::string, RE::NiPointer<RE::NiSourceTexture>> niTextures;
 		};
+
+		// decoded textures of the cpu bake in system memory, immutable so any number of bakes read one image at once
+		// the least recently used images go first when the cache is over SourceTextureCacheSize
+		class TextureCPUCache {
+		public:
+			[[nodiscard]] static TextureCPUCache& GetSingleton() {
+				static TextureCPUCache instance;
+				return instance;
+			}
+
+			struct Image {
+				UINT width = 0;
+				UINT height = 0;
+				UINT rowPitch = 0;
+				DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+				std::vector<std::uint8_t> pixels;
+			};
+			typedef std::shared_ptr<const Image> ImagePtr;
+
+			// minWidth x minHeight is the size the image was requested for, see TextureLoadManager::GetTextureImage
+			ImagePtr Get(const std::string& filePath, DXGI_FORMAT format, UINT minWidth, UINT minHeight);
+			void Insert(const std::string& filePath, DXGI_FORMAT format, UINT minWidth, UINT minHeight, ImagePtr image);
+			void Remove(const std::string& filePath); // every format and size of the file
+			void Clear();
+
+			inline std::uint64_t GetHitCount() const { return hitCount.load(); }
+			inline std::uint64_t GetMissCount() const { return missCount.load(); }
+			inline double GetHitRate() const {
+				const std::uint64_t hit = hitCount.load();
+				const std::uint64_t total = hit + missCount.load();
+				return total > 0 ? static_cast<double>(hit) / static_cast<double>(total) : 0.0;
+			}
+
+		private:
+			static std::string GetFileKey(const std::string& filePath);
+
+			std::mutex lock;
+			struct CacheKey {
+				std::string file;
+				DXGI_FORMAT format;
+				UINT minWidth;
+				UINT minHeight;
+				bool operator==(const CacheKey&) const = default;
+			};
+			struct CacheKeyHash {
+				std::size_t operator()(const CacheKey& key) const {
+					return std::hash<std::string>()(key.file) ^ (static_cast<std::size_t>(key.format) << 48) ^ (static_cast<std::size_t>(key.minWidth) << 24) ^ key.minHeight;
+				}
+			};
+			std::list<CacheKey> lru; // front is the most recently used
+			struct CacheEntry {
+				ImagePtr image;
+				std::list<CacheKey>::iterator lruIt;
+			};
+			std::unordered_map<CacheKey, CacheEntry, CacheKeyHash> map;
+			std::size_t usage = 0; // bytes of the images in the map
+
+			std::atomic<std::uint64_t> hitCount = 0;
+			std::atomic<std::uint64_t> missCount = 0;
+		};
 	}
 }
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+namespace Mus {
+    // binary capture of the inputs of one update, geometry blocks, object infos, texture paths and the config
+    // the layout is in SnapshotFormat.h
+    namespace Snapshot {
+        static_assert(sizeof(RE::BSGraphics::VertexDesc) == sizeof(GeometryRecord::vertexDesc));
+        static_assert(sizeof(RE::FormID) == sizeof(FileHeader::actorID));
+        static_assert(sizeof(bSlot) == sizeof(GeometryRecord::slot));
+
+        // needs the block buffers, so before GetGeometryData
+        bool Write(const std::string& a_path, RE::FormID a_actorID, const GeometryData& a_data, const UpdateSet& a_updateSet);
+
+        struct Capture {
+            RE::FormID actorID = 0;
+            GeometryDataPtr data = nullptr; // as it was before GetGeometryData, the blocks are views into the mapped file until then
+            UpdateSet updateSet;            // geometries are the ids of the capture, never dereference them
+            std::string config;
+            std::unique_ptr<std::uint8_t[]> geometryIDs; // one byte per geometry record, its address is the geometry id
+        };
+        bool Load(const std::string& a_path, Capture& a_capture);
+
+        std::string GetFilePath(RE::FormID a_actorID);
+        std::string GetConfigText();
+    }
+}
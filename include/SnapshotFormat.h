@@ -0,0 +1,88 @@
+#pragma once
+
+namespace Mus {
+    // the file layout of Snapshot, without CommonLibSSE so tools on other platforms can read it
+    // every section starts on a page boundary and every block on 16 bytes, a mapped file is read in place
+    namespace Snapshot {
+        constexpr std::uint64_t magic = 0x50414E534D4E444D; // "MDNMSNAP"
+        constexpr std::uint32_t version = 2;
+        constexpr std::uint64_t sectionAlignment = 4096;
+        constexpr std::uint64_t blockAlignment = 16; // every block can be read as XMFLOAT4 in place
+
+        enum SectionType : std::uint32_t {
+            sectionConfig,     // the main ini as text
+            sectionStrings,    // names and paths, referenced by StringRef
+            sectionGeometries, // GeometryRecord array
+            sectionBlocks,     // raw blocks, referenced by BlockRef
+            sectionTotal
+        };
+
+        struct FileHeader {
+            std::uint64_t magic;
+            std::uint32_t version;
+            std::uint32_t sectionCount;
+            std::uint64_t fileSize;
+            std::uint32_t actorID;
+            std::uint32_t reserved;
+        };
+        struct SectionEntry {
+            std::uint32_t type;
+            std::uint32_t reserved;
+            std::uint64_t offset; // from the file start
+            std::uint64_t size;
+        };
+        // offset and size in bytes from the start of the section
+        struct StringRef {
+            std::uint64_t offset;
+            std::uint64_t size;
+        };
+        struct BlockRef {
+            std::uint64_t offset;
+            std::uint64_t size;
+        };
+
+        enum RecordFlag : std::uint32_t {
+            recordFlagUpdate = 1 << 0 // the geometry is in the update set
+        };
+        struct GeometryRecord {
+            std::uint32_t index; // position of the geometry in the capture, the update set refers to it by this
+            std::uint32_t flags;
+            StringRef name;
+            std::uint64_t vertexDesc; // RE::BSGraphics::VertexDesc
+            std::uint32_t vertexCount;
+            std::uint32_t reserved;
+            BlockRef geometryBlock;
+            BlockRef dynamicBlock1; // NiPoint3 per vertex, without expression
+            BlockRef dynamicBlock2; // XMFLOAT4 per vertex, with expression
+            BlockRef indicesBlock;  // uint16
+
+            // update set, only with recordFlagUpdate
+            std::uint32_t slot;
+            float detailStrength;
+            StringRef textureName;
+            StringRef srcTexturePath;
+            StringRef detailTexturePath;
+            StringRef overlayTexturePath;
+            StringRef maskTexturePath;
+        };
+
+        // the sections of a whole file in memory, every range is checked against the file size
+        struct FileView {
+            const FileHeader* header = nullptr;
+            std::array<std::span<const std::uint8_t>, sectionTotal> sections = {};
+            std::span<const GeometryRecord> records;
+
+            // the magic, version and the section table, header stays set if only the version is wrong
+            bool Parse(std::span<const std::uint8_t> a_file);
+            bool GetString(const StringRef& a_ref, std::string_view& a_out) const;
+            template <typename T>
+            bool GetBlock(const BlockRef& a_ref, std::span<const T>& a_out) const {
+                const auto& blocks = sections[sectionBlocks];
+                if (a_ref.offset > blocks.size() || a_ref.size > blocks.size() - a_ref.offset || a_ref.size % sizeof(T) != 0)
+                    return false;
+                a_out = {reinterpret_cast<const T*>(blocks.data() + a_ref.offset), static_cast<std::size_t>(a_ref.size / sizeof(T))};
+                return true;
+            }
+        };
+    }
+}
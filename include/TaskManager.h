@@ -78,6 +78,9 @@ namespace Mus {
 
 		void RunManageResource(bool isImminently);
 		bool RemoveNormalMap(RE::Actor* a_actor);
+
+		// runs the update of a snapshot again without applying the result, for the timings of each stage
+		void ReplaySnapshot(const std::string& a_path);
 	protected:
 		void onEvent(const FrameEvent& e) override;
 		void onEvent(const FacegenNiNodeEvent& e) override;
@@ -95,6 +98,8 @@ namespace Mus {
 		bool isResetTasks = false;
 
 		bool isPressedExportHotkey1 = false;
+		RE::Actor* GetHotkeyTarget() const;
+		std::atomic<RE::FormID> snapshotActorID = 0; // write a snapshot on the next update of this actor
 
 		bool isAfterLoading = false;
         bool isRevertDone = true;
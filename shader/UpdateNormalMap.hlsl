@@ -13,7 +13,12 @@ cbuffer ConstBuffer : register(b0)
     uint tangentZCorrection;
     float detailStrength;
     uint vertexEnd;
+    uint nlerp;
+
+    uint orthogonalizeTangent;
     uint padding1;
+    uint padding2;
+    uint padding3;
 };
 
 StructuredBuffer<float3> vertices   : register(t0); // a_data->vertices
@@ -83,6 +88,14 @@ float3 SlerpVector(float3 a, float3 b, float t)
     return normalize(a * cos(theta) + relVec * sin(theta));
 }
 
+float3 InterpolateVector(float3 a, float3 b, float3 c, float3 bary)
+{
+    if (nlerp)
+        return normalize(a * bary.x + b * bary.y + c * bary.z);
+    float denormal = bary.x + bary.y + 1e-6f;
+    return SlerpVector(SlerpVector(a, b, bary.y / denormal), c, bary.z);
+}
+
 [numthreads(64, 1, 1)]
 void CSMain(uint3 threadID : SV_DispatchThreadID)
 {
@@ -162,9 +175,7 @@ void CSMain(uint3 threadID : SV_DispatchThreadID)
                 }
                 if (maskColor.a < 1.0f)
                 {
-                    float denormal = bary.x + bary.y + 1e-6f;
-                    float3 n01 = SlerpVector(n0, n1, bary.y / denormal);
-                    float3 n = SlerpVector(n01, n2, bary.z);
+                    float3 n = InterpolateVector(n0, n1, n2, bary);
 
                     float4 detailColor = float4(0.5f, 0.5f, 1.0f, 0.5f);
                     if (hasDetailTexture > 0)
@@ -176,15 +187,17 @@ void CSMain(uint3 threadID : SV_DispatchThreadID)
                     float3 normalResult;
                     if (detailColor.a > 0.0f)
                     {
-                        float3 t01 = SlerpVector(t0, t1, bary.y / denormal);
-                        float3 t = SlerpVector(t01, t2, bary.z);
+                        float3 t = InterpolateVector(t0, t1, t2, bary);
+                        float3 b = InterpolateVector(b0, b1, b2, bary);
 
-                        float3 b01 = SlerpVector(b0, b1, bary.y / denormal);
-                        float3 b = SlerpVector(b01, b2, bary.z);
-
-                        float3 ft = normalize(t - n * dot(n, t));
-                        float handedness = dot(cross(n, t), b) < 0.0f ? -1.0f : 1.0f;
-                        float3 fb = normalize(cross(n, ft)) * handedness;
+                        float3 ft = t;
+                        float3 fb = b;
+                        if (orthogonalizeTangent)
+                        {
+                            ft = normalize(t - n * dot(n, t));
+                            float handedness = dot(cross(n, t), b) < 0.0f ? -1.0f : 1.0f;
+                            fb = normalize(cross(n, ft)) * handedness;
+                        }
                         float3x3 tbn = float3x3(ft, fb, n);
 
                         float3 srcN = float3(detailColor.rgb * 2.0f - 1.0f);
@@ -237,6 +237,16 @@ namespace Mus {
                 {
                     AllowInvertNormalSmooth = GetBoolValue(variableValue);
                 }
+                else if (variableName == "AngleWeightedNormals")
+                {
+                    AngleWeightedNormals = GetBoolValue(variableValue);
+                }
+                else if (variableName == "TangentSpace")
+                {
+                    TangentSpace = GetUIntValue(variableValue);
+                    if (TangentSpace >= TangentSpaceList::TangentSpaceTotal)
+                        TangentSpace = TangentSpaceList::FaceTangent;
+                }
                 else if (variableName == "Subdivision")
                 {
                     Subdivision = GetUIntValue(variableValue);
@@ -253,6 +263,18 @@ namespace Mus {
                 {
                     SubdivisionVertexSmoothStrength = GetFloatValue(variableValue);
                 }
+                else if (variableName == "SubdivisionAdaptive")
+                {
+                    SubdivisionAdaptive = GetBoolValue(variableValue);
+                }
+                else if (variableName == "SubdivisionTexelThreshold")
+                {
+                    SubdivisionTexelThreshold = GetFloatValue(variableValue);
+                }
+                else if (variableName == "SubdivisionAngleThreshold")
+                {
+                    SubdivisionAngleThreshold = GetFloatValue(variableValue);
+                }
                 else if (variableName == "VertexSmooth")
                 {
                     VertexSmooth = GetUIntValue(variableValue);
@@ -296,6 +318,16 @@ namespace Mus {
 				{
                     IgnoreMissingNormalMap = GetBoolValue(variableValue);
 				}
+				else if (variableName == "NormalInterpolation")
+				{
+                    NormalInterpolation = GetUIntValue(variableValue);
+                    if (NormalInterpolation >= NormalInterpolationList::NormalInterpolationTotal)
+                        NormalInterpolation = NormalInterpolationList::Slerp;
+				}
+				else if (variableName == "OrthogonalizeTangent")
+				{
+                    OrthogonalizeTangent = GetBoolValue(variableValue);
+				}
             }
             else if (currentSetting == "[Performance]")
             {
@@ -379,6 +411,26 @@ namespace Mus {
                     std::uint32_t precision = GetUIntValue(variableValue);
                     DiskCacheHashPrecision = 1 << precision;
                 }
+                else if (variableName == "TopologyCacheSize")
+                {
+                    TopologyCacheSize = GetUIntValue(variableValue);
+                }
+                else if (variableName == "FaceDataRebuildThreshold")
+                {
+                    FaceDataRebuildThreshold = std::clamp(GetFloatValue(variableValue), 0.0f, 1.0f);
+                }
+                else if (variableName == "GeometryDataPoolSize")
+                {
+                    GeometryDataPoolSize = GetUIntValue(variableValue);
+                }
+                else if (variableName == "TriangleReorder")
+                {
+                    TriangleReorder = GetBoolValue(variableValue);
+                }
+                else if (variableName == "SourceTextureCacheSize")
+                {
+                    SourceTextureCacheSize = GetUIntValue(variableValue);
+                }
             }
             else if (currentSetting == "[RealtimeDetect]")
             {
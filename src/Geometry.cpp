@@ -29,20 +29,98 @@ namespace Mus {
 		return vertexCount;
 	}
 
+	std::uint64_t GeometryData::GetLayoutHash(RE::BSGeometry* a_geometry)
+	{
+		if (!a_geometry || a_geometry->name.empty())
+			return 0;
+		XXH3_state_t* state = XXH3_createState();
+		XXH3_64bits_reset(state);
+		XXH3_64bits_update(state, a_geometry->name.c_str(), std::strlen(a_geometry->name.c_str()));
+		const std::uint32_t vertexCount = GetVertexCount(a_geometry);
+		XXH3_64bits_update(state, &vertexCount, sizeof(vertexCount));
+		const std::uint64_t hash = XXH3_64bits_digest(state);
+		XXH3_freeState(state);
+		return hash;
+	}
+
+	void GeometryData::Clear()
+	{
+		tp = currentProcessingThreads.load();
+		mainInfo = GeometryInfo();
+		vertices.clear();
+		uvs.clear();
+		normals.clear();
+		tangents.clear();
+		bitangents.clear();
+		indices.clear();
+		arena = std::make_shared<ScratchArena>(); // the texture resources of the last update may still hold the old one
+		geometries.clear();
+		mainGeometryIndex = 0;
+
+		topologyHash = 0;
+		cachedTopology = nullptr;
+		newTopology = nullptr;
+		weldCluster.clear();
+		weldClusters.Clear();
+		vertexPlanes.Clear();
+		uvPlanes.Clear();
+		facePlanes.Clear();
+		faceNormals.Clear();
+		faceTangents.Clear();
+		faceBitangents.Clear();
+		vertexToFaceMap.Clear();
+		edgeTable.Clear();
+		oneRing.Clear();
+		vertexGeometry.clear();
+		bakeOrder.clear();
+		faceOrder.clear();
+	}
+
+	std::size_t GeometryData::GetMemoryUsage() const
+	{
+		std::size_t bytes = vertices.capacity() * sizeof(DirectX::XMFLOAT3)
+		                    + uvs.capacity() * sizeof(DirectX::XMFLOAT2)
+		                    + (normals.capacity() + tangents.capacity() + bitangents.capacity()) * sizeof(DirectX::XMFLOAT3)
+		                    + indices.capacity() * sizeof(std::uint32_t)
+		                    + weldCluster.capacity() * sizeof(std::uint32_t)
+		                    + (weldClusters.offsets.capacity() + weldClusters.items.capacity()) * sizeof(std::uint32_t)
+		                    + (vertexToFaceMap.offsets.capacity() + vertexToFaceMap.items.capacity()) * sizeof(std::uint32_t)
+		                    + (oneRing.offsets.capacity() + oneRing.items.capacity()) * sizeof(std::uint32_t)
+		                    + (vertexPlanes.x.capacity() + faceNormals.x.capacity() + faceTangents.x.capacity() + faceBitangents.x.capacity()) * sizeof(float) * 3
+		                    + uvPlanes.x.capacity() * sizeof(float) * 2
+		                    + facePlanes.i0.capacity() * sizeof(std::uint32_t) * 3
+		                    + edgeTable.halfEdges.capacity() * sizeof(std::uint32_t)
+		                    + edgeTable.v0.capacity() * sizeof(std::uint32_t) * 4
+		                    + vertexGeometry.capacity() * sizeof(std::uint16_t)
+		                    + (bakeOrder.capacity() + faceOrder.capacity()) * sizeof(std::uint32_t);
+		for (const auto& spare : spareObjectInfos)
+		{
+			bytes += spare.geometryBlockData.capacity()
+			         + spare.dynamicBlockData1.capacity() * sizeof(RE::NiPoint3)
+			         + spare.dynamicBlockData2.capacity() * sizeof(DirectX::XMFLOAT4)
+			         + spare.indicesBlockData.capacity() * sizeof(std::uint16_t);
+		}
+		return bytes;
+	}
+
 	bool GeometryData::GetGeometryInfo(RE::BSGeometry* a_geo, GeometryInfo& info)
 	{
 		if (!a_geo || a_geo->name.empty())
 			return false;
 
-		info.desc = a_geo->GetGeometryRuntimeData().vertexDesc;
 		info.name = a_geo->name.c_str();
-		info.hasVertices = info.desc.HasFlag(RE::BSGraphics::Vertex::VF_VERTEX);
-		info.hasUVs = info.desc.HasFlag(RE::BSGraphics::Vertex::VF_UV);
-		info.hasNormals = info.desc.HasFlag(RE::BSGraphics::Vertex::VF_NORMAL);
-		info.hasTangents = info.desc.HasFlag(RE::BSGraphics::Vertex::VF_TANGENT);
-		info.hasBitangents = info.hasVertices && info.hasNormals && info.hasTangents;
+		info.SetDesc(a_geo->GetGeometryRuntimeData().vertexDesc);
 		return true;
 	}
+	void GeometryData::GeometryInfo::SetDesc(const RE::BSGraphics::VertexDesc& a_desc)
+	{
+		desc = a_desc;
+		hasVertices = desc.HasFlag(RE::BSGraphics::Vertex::VF_VERTEX);
+		hasUVs = desc.HasFlag(RE::BSGraphics::Vertex::VF_UV);
+		hasNormals = desc.HasFlag(RE::BSGraphics::Vertex::VF_NORMAL);
+		hasTangents = desc.HasFlag(RE::BSGraphics::Vertex::VF_TANGENT);
+		hasBitangents = hasVertices && hasNormals && hasTangents;
+	}
 	bool GeometryData::CopyGeometryData(RE::BSGeometry* a_geo)
 	{
 		if (!a_geo || a_geo->name.empty())
@@ -52,6 +130,21 @@ namespace Mus {
 		if (!GetGeometryInfo(a_geo, newObjInfo.info))
 			return false;
 
+		// reuse the block buffers of the last update, the same geometry most likely has the same size
+		if (!spareObjectInfos.empty())
+		{
+			auto spare = std::find_if(spareObjectInfos.begin(), spareObjectInfos.end(), [&](const ObjectInfo& objInfo) {
+				return objInfo.info.name == newObjInfo.info.name;
+			});
+			if (spare == spareObjectInfos.end())
+				spare = std::prev(spareObjectInfos.end());
+			newObjInfo.geometryBlockData = std::move(spare->geometryBlockData);
+			newObjInfo.dynamicBlockData1 = std::move(spare->dynamicBlockData1);
+			newObjInfo.dynamicBlockData2 = std::move(spare->dynamicBlockData2);
+			newObjInfo.indicesBlockData = std::move(spare->indicesBlockData);
+			spareObjectInfos.erase(spare);
+		}
+
 		if (Config::GetSingleton().GetGeometryDataTime())
 			PerformanceLog(std::string(__func__) + "::" + newObjInfo.info.name, false, false);
 
@@ -92,26 +185,31 @@ namespace Mus {
 		for (auto& partition : skinPartition->partitions)
 		{
 			const std::size_t indicesCount = (std::size_t)partition.triangles * 3;
-			std::vector<std::uint16_t> indicesBlockData_(indicesCount);
-			std::memcpy(indicesBlockData_.data(), partition.triList, sizeof(std::uint16_t) * indicesCount);
-			newObjInfo.indicesBlockData.insert(newObjInfo.indicesBlockData.end(), indicesBlockData_.begin(), indicesBlockData_.end());
+			const std::size_t indicesOffset = newObjInfo.indicesBlockData.size();
+			newObjInfo.indicesBlockData.resize(indicesOffset + indicesCount);
+			std::memcpy(newObjInfo.indicesBlockData.data() + indicesOffset, partition.triList, sizeof(std::uint16_t) * indicesCount);
 		}
-		geometries.push_back(GeometriesInfo{ a_geo, newObjInfo });
+		const std::string geometryName = newObjInfo.info.name;
+		AddGeometry(a_geo, std::move(newObjInfo));
+
+		if (Config::GetSingleton().GetGeometryDataTime())
+			PerformanceLog(std::string(__func__) + "::" + geometryName, true, false);
+
+		return true;
+	}
+	void GeometryData::AddGeometry(RE::BSGeometry* a_geo, ObjectInfo&& a_objInfo)
+	{
+		geometries.push_back(GeometriesInfo{ a_geo, std::move(a_objInfo) });
 
 		if (geometries.size() > 1) {
-			if (geometries[mainGeometryIndex].objInfo.indicesBlockData.size() < geometries[geometries.size() - 1].objInfo.indicesBlockData.size())
+			if (geometries[mainGeometryIndex].objInfo.GetIndicesBlock().size() < geometries[geometries.size() - 1].objInfo.GetIndicesBlock().size())
 			{
 				mainGeometryIndex = geometries.size() - 1;
 				mainInfo = geometries[mainGeometryIndex].objInfo.info;
 			}
 		}
 		else
-			mainInfo = newObjInfo.info;
-
-		if (Config::GetSingleton().GetGeometryDataTime())
-			PerformanceLog(std::string(__func__) + "::" + newObjInfo.info.name, true, false);
-
-		return true;
+			mainInfo = geometries.back().objInfo.info;
 	}
 	void GeometryData::GetGeometryData()
 	{
@@ -131,51 +229,58 @@ namespace Mus {
             const std::size_t beforeIndices = indices.size();
 
 			const std::uint32_t vertexSize = geo.objInfo.info.desc.GetSize();
-            const std::uint32_t triCount = geo.objInfo.indicesBlockData.size() / 3;
+			const auto dynamicBlock1 = geo.objInfo.GetDynamicBlock1();
+			const auto dynamicBlock2 = geo.objInfo.GetDynamicBlock2();
+			const auto indicesBlock = geo.objInfo.GetIndicesBlock();
+            const std::uint32_t triCount = indicesBlock.size() / 3;
 
 			vertices.resize(beforeVertexCount + geo.objInfo.info.vertexCount);
             uvs.resize(beforeUVCount + geo.objInfo.info.vertexCount);
-            indices.resize(beforeIndices + geo.objInfo.indicesBlockData.size());
+            indices.resize(beforeIndices + indicesBlock.size());
 
-			for (std::size_t i = 0; i < geo.objInfo.info.vertexCount; i++) {
-				std::uint8_t* block = &geo.objInfo.geometryBlockData[i * vertexSize];
-                const std::size_t vi = beforeVertexCount + i;
-                const std::size_t ui = beforeUVCount + i;
-
-				if (!geo.objInfo.dynamicBlockData1.empty())
-				{
-					vertices[vi].x = geo.objInfo.dynamicBlockData1[i].x;
-					vertices[vi].y = geo.objInfo.dynamicBlockData1[i].y;
-					vertices[vi].z = geo.objInfo.dynamicBlockData1[i].z;
-				}
-				else if (!geo.objInfo.dynamicBlockData2.empty())
-				{
-					vertices[vi].x = geo.objInfo.dynamicBlockData2[i].x;
-					vertices[vi].y = geo.objInfo.dynamicBlockData2[i].y;
-					vertices[vi].z = geo.objInfo.dynamicBlockData2[i].z;
-				}
-				if (geo.objInfo.info.hasVertices)
+			if (!dynamicBlock1.empty())
+			{
+				for (std::size_t i = 0; i < geo.objInfo.info.vertexCount; i++)
 				{
-					vertices[vi] = *reinterpret_cast<DirectX::XMFLOAT3*>(block);
-					block += 12;
-					block += 4;
+					const std::size_t vi = beforeVertexCount + i;
+					vertices[vi].x = dynamicBlock1[i].x;
+					vertices[vi].y = dynamicBlock1[i].y;
+					vertices[vi].z = dynamicBlock1[i].z;
 				}
-				if (geo.objInfo.info.hasUVs)
+			}
+			else if (!dynamicBlock2.empty())
+			{
+				for (std::size_t i = 0; i < geo.objInfo.info.vertexCount; i++)
 				{
-					uvs[ui].x = DirectX::PackedVector::XMConvertHalfToFloat(*reinterpret_cast<std::uint16_t*>(block));
-                    uvs[ui].x -= floor(uvs[ui].x);
-                    uvs[ui].y = DirectX::PackedVector::XMConvertHalfToFloat(*reinterpret_cast<std::uint16_t*>(block + 2));
-                    uvs[ui].y -= floor(uvs[ui].y);
-					block += 4;
+					const std::size_t vi = beforeVertexCount + i;
+					vertices[vi].x = dynamicBlock2[i].x;
+					vertices[vi].y = dynamicBlock2[i].y;
+					vertices[vi].z = dynamicBlock2[i].z;
 				}
 			}
 
+			// the format is fixed per geometry, so pick the decoder once instead of checking the flags per vertex
+			const std::uint32_t format = (geo.objInfo.info.hasVertices ? GeometryKernel::vertexFormatPosition : 0) |
+			                             (geo.objInfo.info.hasUVs ? GeometryKernel::vertexFormatUV : 0);
+			const GeometryKernel::VertexDecoder decoder = GeometryKernel::GetVertexDecoder(format);
+			const std::uint8_t* blocks = geo.objInfo.GetGeometryBlock().data();
+			tp->Execute([&] {
+				tbb::parallel_for(
+					tbb::blocked_range<std::size_t>(0, geo.objInfo.info.vertexCount, 1024),
+					[&](const tbb::blocked_range<std::size_t>& r) {
+						decoder(blocks + r.begin() * vertexSize, vertexSize, r.size(),
+								vertices.data() + beforeVertexCount + r.begin(), uvs.data() + beforeUVCount + r.begin());
+					},
+					tbb::auto_partitioner()
+				);
+			});
+
             for (std::uint32_t i = 0; i < triCount; i++)
             {
                 const std::uint32_t offset = i * 3;
-                indices[beforeIndices + offset + 0] = beforeVertexCount + geo.objInfo.indicesBlockData[offset + 0];
-                indices[beforeIndices + offset + 1] = beforeVertexCount + geo.objInfo.indicesBlockData[offset + 1];
-                indices[beforeIndices + offset + 2] = beforeVertexCount + geo.objInfo.indicesBlockData[offset + 2];
+                indices[beforeIndices + offset + 0] = beforeVertexCount + indicesBlock[offset + 0];
+                indices[beforeIndices + offset + 1] = beforeVertexCount + indicesBlock[offset + 1];
+                indices[beforeIndices + offset + 2] = beforeVertexCount + indicesBlock[offset + 2];
 			}
 
 			geo.objInfo.vertexStart = beforeVertexCount;
@@ -188,6 +293,24 @@ namespace Mus {
 			logger::info("{}::{} : get geometry data => vertices {} / uvs {} / tris {}", __func__, geo.objInfo.info.name.c_str(),
 						 geo.objInfo.vertexCount(), geo.objInfo.uvCount(), geo.objInfo.indicesCount() / 3);
 		}
+		BuildVertexGeometry();
+
+		// the block data is decoded now, keep only the buffers for the next update
+		spareObjectInfos.clear();
+		for (auto& geo : geometries)
+		{
+			ObjectInfo& spare = spareObjectInfos.emplace_back();
+			spare.info.name = geo.objInfo.info.name;
+			spare.geometryBlockData = std::move(geo.objInfo.geometryBlockData);
+			spare.dynamicBlockData1 = std::move(geo.objInfo.dynamicBlockData1);
+			spare.dynamicBlockData2 = std::move(geo.objInfo.dynamicBlockData2);
+			spare.indicesBlockData = std::move(geo.objInfo.indicesBlockData);
+			spare.geometryBlockData.clear();
+			spare.dynamicBlockData1.clear();
+			spare.dynamicBlockData2.clear();
+			spare.indicesBlockData.clear();
+			geo.objInfo.blockSource = nullptr; // the views of a snapshot are not read after this, the last geometry unmaps it
+		}
 		if (Config::GetSingleton().GetGeometryDataTime())
 			PerformanceLog(std::string(__func__) + "::" + mainInfo.name, true, false);
 	}
@@ -203,29 +326,48 @@ namespace Mus {
         if (Config::GetSingleton().GetGeometryDataTime())
             PerformanceLog(std::string(__func__) + "::" + std::to_string(triCount), false, false);
 
-        // create vertex to face map and edge map
-        vertexToFaceMap.clear();
-        vertexToFaceMap.resize(vertCount);
-        std::vector<Edge> edges(indices.size());
+        // create topology, reuse the cached one if only the vertex positions changed
+        // the faces are put in vertex order first, the topology is built on the new face ids
+        if (cachedTopology && cachedTopology->base.weldCluster.size() == vertCount)
+        {
+            faceOrder = cachedTopology->faceOrder;
+            ApplyFaceOrder();
+            LoadTopology(cachedTopology->base);
+            logger::debug("{}::{} : topology cache hit", __func__, mainInfo.name);
+        }
+        else
+        {
+            BuildFaceOrder();
+            ApplyFaceOrder();
+            BuildTopology(weldAccuracy);
+            if (newTopology)
+            {
+                SaveTopology(newTopology->base);
+                newTopology->faceOrder = faceOrder;
+            }
+        }
+
+        // weld vertices
         {
             tp->Execute([&] {
                 tbb::parallel_for(
-                    tbb::blocked_range<std::size_t>(0, triCount),
+                    tbb::blocked_range<std::size_t>(0, weldClusters.size()),
                     [&](const tbb::blocked_range<std::size_t>& r) {
-                        for (std::size_t i = r.begin(); i != r.end(); ++i)
+                        for (std::size_t ci = r.begin(); ci != r.end(); ++ci)
                         {
-                            const std::size_t offset = i * 3;
-                            const std::uint32_t i0 = indices[offset + 0];
-                            const std::uint32_t i1 = indices[offset + 1];
-                            const std::uint32_t i2 = indices[offset + 2];
-                            if (i0 >= vertCount || i1 >= vertCount || i2 >= vertCount)
-                                break;
-                            edges[offset + 0] = {i0, i1};
-                            edges[offset + 1] = {i1, i2};
-                            edges[offset + 2] = {i0, i2};
-                            vertexToFaceMap[i0].push_back(i);
-                            vertexToFaceMap[i1].push_back(i);
-                            vertexToFaceMap[i2].push_back(i);
+                            const auto members = weldClusters[ci];
+                            if (members.size() < 2)
+                                continue;
+                            DirectX::XMVECTOR pos = emptyVector;
+                            for (const auto& vi : members)
+                            {
+                                pos = DirectX::XMVectorAdd(pos, DirectX::XMLoadFloat3(&vertices[vi]));
+                            }
+                            pos = DirectX::XMVectorScale(pos, 1.0f / members.size());
+                            for (const auto& vi : members)
+                            {
+                                DirectX::XMStoreFloat3(&vertices[vi], pos);
+                            }
                         }
                     },
                     tbb::auto_partitioner()
@@ -233,27 +375,23 @@ namespace Mus {
             });
         }
 
-        // create boundary map
-        tp->Execute([&] {
-            tbb::parallel_sort(edges);
-        });
-        std::vector<std::uint8_t> isBoundaryVert(vertCount, 0);
-        std::size_t i = 0;
-        while (i < edges.size())
-        {
-            std::size_t count = 1;
-            while (i + count < edges.size() && edges[i] == edges[i + count])
-            {
-                count++;
-            }
+        logger::debug("{}::{} : map updated, vertices {} / uvs {} / tris {}", __func__,
+                      mainInfo.name, vertices.size(), uvs.size(), triCount);
 
-            if (count == 1)
-            {
-                isBoundaryVert[edges[i].v0] = 1;
-                isBoundaryVert[edges[i].v1] = 1;
-            }
-            i += count;
-        }
+        if (Config::GetSingleton().GetGeometryDataTime())
+            PerformanceLog(std::string(__func__) + "::" + std::to_string(triCount), true, false);
+        
+        UpdateFacePlanes();
+        CreateFaceData();
+    }
+
+	void GeometryData::BuildTopology(bool weldAccuracy)
+	{
+        const std::size_t vertCount = vertices.size();
+
+        // create vertex to face map and edge map
+        vertexToFaceMap.Build(vertCount, indices, 3, tp.get());
+        edgeTable.Build(indices, vertCount, tp.get());
 
         // create pos map for weld
         std::vector<PosEntry> pMap;
@@ -276,7 +414,7 @@ namespace Mus {
                             {
                                 pMap[i * 2 + 0] = PosEntry(MakeLowPositionKey(vertices[i]), i);
                                 pMap[i * 2 + 1] = PosEntry(MakeHighPositionKey(vertices[i]), i);
-                                if (isBoundaryVert[i])
+                                if (edgeTable.IsBoundaryVertex(i))
                                 {
                                     tpbMap[ti].data.emplace_back(MakeLowBoundaryPositionKey(vertices[i]), i);
                                     tpbMap[ti].data.emplace_back(MakeHighBoundaryPositionKey(vertices[i]), i);
@@ -298,7 +436,7 @@ namespace Mus {
                             for (std::size_t i = r.begin(); i != r.end(); ++i)
                             {
                                 pMap[i] = PosEntry(MakePositionKey(vertices[i]), i);
-                                if (isBoundaryVert[i])
+                                if (edgeTable.IsBoundaryVertex(i))
                                     tpbMap[ti].data.emplace_back(MakeBoundaryPositionKey(vertices[i]), i);
                             }
                         },
@@ -311,136 +449,130 @@ namespace Mus {
         {
             pbMap.append_range(m.data);
         }
-        tp->Execute([&] {
-            tbb::parallel_sort(pMap);
-            tbb::parallel_sort(pbMap);
-        });
+        parallel_sort(pMap, tp.get());
+        parallel_sort(pbMap, tp.get());
 
         // create weld map
-        weldedVertices.clear();
-        weldedVertices.resize(vertCount);
-        if (weldAccuracy)
+        GeometryKernel::DisjointSet weldSet;
+        weldSet.Reset(vertCount);
+        AddWeldVertices(pMap, weldSet);
+        AddWeldBoundaryVertices(pbMap, weldSet);
+        BuildWeldClusters(weldSet);
+	}
+
+	void GeometryData::BuildVertexGeometry()
+	{
+        vertexGeometry.assign(vertices.size(), invalidGeometry);
+        for (std::size_t gi = 0; gi < geometries.size(); gi++)
         {
-            tp->Execute([&] {
-                tbb::parallel_invoke(
-                    [&] {
-                        pMap.erase(std::unique(pMap.begin(), pMap.end()), pMap.end());
-                    },
-                    [&] {
-                        pbMap.erase(std::unique(pbMap.begin(), pbMap.end()), pbMap.end());
-                    }
-                );
-            });
+            const auto& objInfo = geometries[gi].objInfo;
+            std::fill(vertexGeometry.begin() + objInfo.vertexStart, vertexGeometry.begin() + objInfo.vertexEnd, static_cast<std::uint16_t>(gi));
         }
-        AddWeldVertices(pMap);
-        AddWeldBoundaryVertices(pbMap);
+	}
 
-        // weld vertices
+	void GeometryData::BuildFaceOrder()
+	{
+        faceOrder.clear();
+        if (!Config::GetSingleton().GetTriangleReorder())
+            return;
+        faceOrder.resize(indices.size() / 3);
+        for (const auto& geo : geometries)
         {
-            const auto vertices_ = vertices;
-            tp->Execute([&] {
-                tbb::parallel_for(
-                    tbb::blocked_range<std::size_t>(0, vertCount),
-                    [&](const tbb::blocked_range<std::size_t>& r) {
-                        for (std::size_t i = r.begin(); i != r.end(); ++i)
-                        {
-                            std::sort(weldedVertices[i].begin(), weldedVertices[i].end());
-                            weldedVertices[i].erase(std::unique(weldedVertices[i].begin(), weldedVertices[i].end()), weldedVertices[i].end());
+            GeometryKernel::BuildVertexOrder(indices, vertices.size(), geo.objInfo.indicesStart / 3, geo.objInfo.indicesEnd / 3, faceOrder, tp.get());
+        }
+	}
 
-                            DirectX::XMVECTOR pos = emptyVector;
-                            for (const auto& vi : weldedVertices[i])
-                            {
-                                pos = DirectX::XMVectorAdd(pos, DirectX::XMLoadFloat3(&vertices_[vi]));
-                            }
-                            pos = DirectX::XMVectorScale(pos, 1.0f / weldedVertices[i].size());
-                            DirectX::XMStoreFloat3(&vertices[i], pos);
-                        }
-                    },
-                    tbb::auto_partitioner()
-                );
-            });
+	void GeometryData::ApplyFaceOrder()
+	{
+        const std::size_t faceCount = indices.size() / 3;
+        if (faceOrder.size() != faceCount)
+        {
+            faceOrder.clear();
+            return;
+        }
+        std::vector<std::uint32_t> ordered(indices.size());
+        tp->Execute([&] {
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>(0, faceCount),
+                [&](const tbb::blocked_range<std::size_t>& r) {
+                    for (std::size_t f = r.begin(); f != r.end(); ++f)
+                    {
+                        std::memcpy(&ordered[f * 3], &indices[faceOrder[f] * 3], sizeof(std::uint32_t) * 3);
+                    }
+                },
+                tbb::auto_partitioner()
+            );
+        });
+        indices.swap(ordered);
+	}
+
+	void GeometryData::BuildBakeOrder(bool a_cacheable)
+	{
+        bakeOrder.clear();
+        if (!Config::GetSingleton().GetTriangleReorder())
+            return;
+        const std::size_t faceCount = indices.size() / 3;
+        if (a_cacheable && cachedTopology && cachedTopology->bakeOrder.size() == faceCount)
+        {
+            bakeOrder = cachedTopology->bakeOrder;
+            return;
         }
 
-        logger::debug("{}::{} : map updated, vertices {} / uvs {} / tris {}", __func__,
-                      mainInfo.name, vertices.size(), uvs.size(), triCount);
+        // faces stay in the range of their geometry
+        bakeOrder.resize(faceCount);
+        for (const auto& geo : geometries)
+        {
+            GeometryKernel::BuildUVOrder(indices, uvs, geo.objInfo.indicesStart / 3, geo.objInfo.indicesEnd / 3, bakeOrder, tp.get());
+        }
+        if (a_cacheable && newTopology)
+            newTopology->bakeOrder = bakeOrder;
+	}
 
-        if (Config::GetSingleton().GetGeometryDataTime())
-            PerformanceLog(std::string(__func__) + "::" + std::to_string(triCount), true, false);
-        
-        CreateFaceData();
-    }
+	void GeometryData::SaveTopology(TopologyData& data) const
+	{
+        data.vertexToFaceMap = vertexToFaceMap;
+        data.edgeTable = edgeTable;
+        data.weldCluster = weldCluster;
+        data.weldClusters = weldClusters;
+	}
+
+	void GeometryData::LoadTopology(const TopologyData& data)
+	{
+        vertexToFaceMap = data.vertexToFaceMap;
+        edgeTable = data.edgeTable;
+        weldCluster = data.weldCluster;
+        weldClusters = data.weldClusters;
+	}
+
+	void GeometryData::UpdateFacePlanes()
+	{
+        facePlanes.Load(indices, vertices.size(), tp.get());
+        uvPlanes.Load(uvs, tp.get());
+	}
+
+	void GeometryData::BuildWeldClusters(GeometryKernel::DisjointSet& weldSet)
+	{
+        const std::uint32_t clusterCount = weldSet.Flatten(weldCluster);
+        weldClusters.Build(clusterCount, weldCluster, 1, tp.get());
+	}
 
 	void GeometryData::CreateFaceData()
     {
 		const std::size_t triCount = indices.size() / 3;
-        const std::size_t vertCount = vertices.size();
         if (Config::GetSingleton().GetGeometryDataTime())
             PerformanceLog(std::string(__func__) + "::" + std::to_string(triCount), false, false);
 
-        faceNormals.resize(triCount);
-        faceTangents.resize(triCount);
+        vertexPlanes.Load(vertices, tp.get());
+        faceNormals.Resize(triCount);
+        faceTangents.Resize(triCount);
+        faceBitangents.Resize(triCount);
         {
             tp->Execute([&] {
                 tbb::parallel_for(
-                    tbb::blocked_range<std::size_t>(0, triCount),
+                    tbb::blocked_range<std::size_t>(0, GeometryKernel::BlockCount(triCount)),
                     [&](const tbb::blocked_range<std::size_t>& r) {
-                        for (std::size_t i = r.begin(); i != r.end(); ++i)
-                        {
-                            const std::size_t offset = i * 3;
-                            const std::uint32_t i0 = indices[offset + 0];
-                            const std::uint32_t i1 = indices[offset + 1];
-                            const std::uint32_t i2 = indices[offset + 2];
-                            if (i0 >= vertCount || i1 >= vertCount || i2 >= vertCount)
-                                break;
-
-                            const DirectX::XMFLOAT3& p0 = vertices[i0];
-                            const DirectX::XMFLOAT3& p1 = vertices[i1];
-                            const DirectX::XMFLOAT3& p2 = vertices[i2];
-
-                            const DirectX::XMVECTOR v0 = DirectX::XMLoadFloat3(&p0);
-                            const DirectX::XMVECTOR v1 = DirectX::XMLoadFloat3(&p1);
-                            const DirectX::XMVECTOR v2 = DirectX::XMLoadFloat3(&p2);
-
-                            const DirectX::XMFLOAT2& uv0 = uvs[i0];
-                            const DirectX::XMFLOAT2& uv1 = uvs[i1];
-                            const DirectX::XMFLOAT2& uv2 = uvs[i2];
-
-                            // Normal
-                            const DirectX::XMVECTOR normalVec = DirectX::XMVector4NormalizeEst(
-                                DirectX::XMVector3Cross(
-                                    DirectX::XMVectorSubtract(v1, v0),
-                                    DirectX::XMVectorSubtract(v2, v0)));
-                            DirectX::XMFLOAT3 normal;
-                            DirectX::XMStoreFloat3(&normal, normalVec);
-                            faceNormals[i] = {i0, i1, i2, normal};
-
-                            // Tangent / Bitangent
-                            const DirectX::XMVECTOR dp1 = DirectX::XMVectorSubtract(v1, v0);
-                            const DirectX::XMVECTOR dp2 = DirectX::XMVectorSubtract(v2, v0);
-
-                            const DirectX::XMFLOAT2 duv1 = {uv1.x - uv0.x, uv1.y - uv0.y};
-                            const DirectX::XMFLOAT2 duv2 = {uv2.x - uv0.x, uv2.y - uv0.y};
-
-                            float r = duv1.x * duv2.y - duv2.x * duv1.y;
-                            r = (fabs(r) < floatPrecision) ? 1.0f : 1.0f / r;
-
-                            const DirectX::XMVECTOR tangentVec = DirectX::XMVectorScale(
-                                DirectX::XMVectorSubtract(
-                                    DirectX::XMVectorScale(dp1, duv2.y),
-                                    DirectX::XMVectorScale(dp2, duv1.y)),
-                                r);
-
-                            const DirectX::XMVECTOR bitangentVec = DirectX::XMVectorScale(
-                                DirectX::XMVectorSubtract(
-                                    DirectX::XMVectorScale(dp2, duv1.x),
-                                    DirectX::XMVectorScale(dp1, duv2.x)),
-                                r);
-
-                            DirectX::XMFLOAT3 tangent, bitangent;
-                            DirectX::XMStoreFloat3(&tangent, tangentVec);
-                            DirectX::XMStoreFloat3(&bitangent, bitangentVec);
-                            faceTangents[i] = {i0, i1, i2, tangent, bitangent};
-                        }
+                        GeometryKernel::ComputeFaceData(vertexPlanes, uvPlanes, facePlanes, r.begin(), r.end(),
+                                                        faceNormals, faceTangents, faceBitangents);
                     },
                     tbb::auto_partitioner()
                 );
@@ -454,6 +586,71 @@ namespace Mus {
             PerformanceLog(std::string(__func__) + "::" + std::to_string(triCount), true, false);
     }
 
+	void GeometryData::UpdateFaceData(std::span<const std::uint8_t> movedVertices)
+	{
+        const std::size_t vertCount = vertices.size();
+        const std::size_t triCount = indices.size() / 3;
+        const std::size_t movedCount = std::count(movedVertices.begin(), movedVertices.end(), 1);
+        if (movedCount == 0)
+            return;
+        if (movedVertices.size() != vertCount || vertexPlanes.count != vertCount || faceNormals.count != triCount ||
+            movedCount > vertCount * Config::GetSingleton().GetFaceDataRebuildThreshold())
+        {
+            CreateFaceData();
+            return;
+        }
+
+        if (Config::GetSingleton().GetGeometryDataTime())
+            PerformanceLog(std::string(__func__) + "::" + std::to_string(triCount), false, false);
+
+        tp->Execute([&] {
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>(0, vertCount),
+                [&](const tbb::blocked_range<std::size_t>& r) {
+                    for (std::size_t i = r.begin(); i != r.end(); ++i)
+                    {
+                        if (!movedVertices[i])
+                            continue;
+                        vertexPlanes.x[i] = vertices[i].x;
+                        vertexPlanes.y[i] = vertices[i].y;
+                        vertexPlanes.z[i] = vertices[i].z;
+                    }
+                },
+                tbb::auto_partitioner()
+            );
+        });
+
+        // the kernel works on blocks of faces, so recalculate every block with a face touching a moved vertex
+        tp->Execute([&] {
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>(0, GeometryKernel::BlockCount(triCount)),
+                [&](const tbb::blocked_range<std::size_t>& r) {
+                    for (std::size_t block = r.begin(); block != r.end(); ++block)
+                    {
+                        const std::size_t faceEnd = std::min((block + 1) * GeometryKernel::laneWidth, triCount);
+                        bool dirty = false;
+                        for (std::size_t fi = block * GeometryKernel::laneWidth; fi < faceEnd && !dirty; fi++)
+                        {
+                            dirty = movedVertices[facePlanes.i0[fi]] || movedVertices[facePlanes.i1[fi]] || movedVertices[facePlanes.i2[fi]];
+                        }
+                        if (dirty)
+                        {
+                            GeometryKernel::ComputeFaceData(vertexPlanes, uvPlanes, facePlanes, block, block + 1,
+                                                            faceNormals, faceTangents, faceBitangents);
+                        }
+                    }
+                },
+                tbb::auto_partitioner()
+            );
+        });
+
+        logger::debug("{}::{} : map data updated for {} moved vertices, vertices {} / uvs {} / tris {}", __func__,
+                      mainInfo.name, movedCount, vertices.size(), uvs.size(), triCount);
+
+        if (Config::GetSingleton().GetGeometryDataTime())
+            PerformanceLog(std::string(__func__) + "::" + std::to_string(triCount), true, false);
+	}
+
 	void GeometryData::RecalculateNormals(float a_smoothDegree)
 	{
         if (vertices.empty() || indices.empty() || vertexToFaceMap.empty() || a_smoothDegree < floatPrecision)
@@ -486,75 +683,165 @@ namespace Mus {
 		const float smoothCos = std::cosf(DirectX::XMConvertToRadians(a_smoothDegree));
         const bool allowInvertNormalSmooth = Config::GetSingleton().GetAllowInvertNormalSmooth();
 
+        const std::size_t vertCount = vertices.size();
+        const bool angleWeighted = Config::GetSingleton().GetAngleWeightedNormals();
+
+        // phase 1 : faces of every weld cluster in one flat list, with the corner angle as weight if needed
+        const std::size_t clusterCount = weldClusters.size();
+        std::pmr::vector<std::uint32_t> clusterFaceOffsets(clusterCount + 1, 0, arena->Get());
         tp->Execute([&] {
             tbb::parallel_for(
-                tbb::blocked_range<std::size_t>(0, vertices.size()),
+                tbb::blocked_range<std::size_t>(0, clusterCount),
                 [&](const tbb::blocked_range<std::size_t>& r) {
-                    for (std::size_t i = r.begin(); i != r.end(); ++i)
+                    for (std::size_t ci = r.begin(); ci != r.end(); ++ci)
                     {
-                        DirectX::XMVECTOR nSelf = emptyVector;
-                        if (vertexToFaceMap[i].empty())
-                            continue;
-                        for (const auto& fi : vertexToFaceMap[i])
+                        std::uint32_t count = 0;
+                        for (const auto& link : weldClusters[ci])
                         {
-                            const auto& fn = faceNormals[fi];
-                            nSelf = DirectX::XMVectorAdd(nSelf, DirectX::XMLoadFloat3(&fn.normal));
+                            count += vertexToFaceMap[link].size();
                         }
-                        if (DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(nSelf)) < floatPrecision)
-                            continue;
-                        nSelf = DirectX::XMVector3Normalize(nSelf);
-
-                        DirectX::XMVECTOR nSum = emptyVector;
-                        DirectX::XMVECTOR tSum = emptyVector;
-                        DirectX::XMVECTOR bSum = emptyVector;
-
-                        for (const auto& link : weldedVertices[i])
+                        clusterFaceOffsets[ci + 1] = count;
+                    }
+                },
+                tbb::auto_partitioner()
+            );
+        });
+        std::partial_sum(clusterFaceOffsets.begin(), clusterFaceOffsets.end(), clusterFaceOffsets.begin());
+        std::pmr::vector<std::uint32_t> clusterFaces(clusterFaceOffsets[clusterCount], arena->Get());
+        std::pmr::vector<float> clusterFaceWeights(angleWeighted ? clusterFaces.size() : 0, arena->Get());
+        tp->Execute([&] {
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>(0, clusterCount),
+                [&](const tbb::blocked_range<std::size_t>& r) {
+                    for (std::size_t ci = r.begin(); ci != r.end(); ++ci)
+                    {
+                        std::uint32_t pos = clusterFaceOffsets[ci];
+                        for (const auto& link : weldClusters[ci])
                         {
                             for (const auto& fi : vertexToFaceMap[link])
                             {
-                                const auto& fn = faceNormals[fi];
-                                DirectX::XMVECTOR fnVec = DirectX::XMLoadFloat3(&fn.normal);
-                                float dot = DirectX::XMVectorGetX(DirectX::XMVector3Dot(fnVec, nSelf));
-                                if (allowInvertNormalSmooth)
+                                clusterFaces[pos] = fi;
+                                if (angleWeighted)
                                 {
-                                    if (dot < 0)
-                                    {
-                                        dot = -dot;
-                                        fnVec = DirectX::XMVectorNegate(fnVec);
-                                    }
+                                    const std::uint32_t corner[3] = {facePlanes.i0[fi], facePlanes.i1[fi], facePlanes.i2[fi]};
+                                    const std::uint32_t k = corner[0] == link ? 0 : (corner[1] == link ? 1 : 2);
+                                    const DirectX::XMVECTOR p = DirectX::XMLoadFloat3(&vertices[link]);
+                                    const DirectX::XMVECTOR e1 = DirectX::XMVector3Normalize(DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&vertices[corner[(k + 1) % 3]]), p));
+                                    const DirectX::XMVECTOR e2 = DirectX::XMVector3Normalize(DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&vertices[corner[(k + 2) % 3]]), p));
+                                    clusterFaceWeights[pos] = std::acosf(std::clamp(DirectX::XMVectorGetX(DirectX::XMVector3Dot(e1, e2)), -1.0f, 1.0f));
                                 }
-                                if (dot < smoothCos)
-                                    continue;
-                                const auto& ft = faceTangents[fi];
-                                nSum = DirectX::XMVectorAdd(nSum, fnVec);
-                                tSum = DirectX::XMVectorAdd(tSum, DirectX::XMLoadFloat3(&ft.tangent));
-                                bSum = DirectX::XMVectorAdd(bSum, DirectX::XMLoadFloat3(&ft.bitangent));
+                                pos++;
                             }
                         }
+                    }
+                },
+                tbb::auto_partitioner()
+            );
+        });
 
-                        if (DirectX::XMVector3Equal(nSum, emptyVector))
-                            continue;
+        // phase 2 : gather, faces outside of the smooth angle are masked out instead of branched
+        GeometryKernel::Float3Planes nSums, tSums, bSums;
+        nSums.Resize(vertCount);
+        tSums.Resize(vertCount);
+        bSums.Resize(vertCount);
+        AlignedVector<std::uint32_t> valid(GeometryKernel::PaddedSize(vertCount), 0);
+        auto gather = [&]<bool invert, bool weighted>() {
+            tp->Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, vertCount),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                        const DirectX::XMVECTOR smoothCosV = DirectX::XMVectorReplicate(smoothCos);
+                        for (std::size_t i = r.begin(); i != r.end(); ++i)
+                        {
+                            DirectX::XMVECTOR nSelf = emptyVector;
+                            if (vertexToFaceMap[i].empty())
+                                continue;
+                            for (const auto& fi : vertexToFaceMap[i])
+                            {
+                                nSelf = DirectX::XMVectorAdd(nSelf, faceNormals.Get(fi));
+                            }
+                            if (DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(nSelf)) < floatPrecision)
+                                continue;
+                            nSelf = DirectX::XMVector3Normalize(nSelf);
 
-                        DirectX::XMVECTOR t = DirectX::XMVectorGetX(DirectX::XMVector3LengthEst(tSum)) > floatPrecision ? DirectX::XMVector3NormalizeEst(tSum) : emptyVector;
-                        DirectX::XMVECTOR b = DirectX::XMVectorGetX(DirectX::XMVector3LengthEst(bSum)) > floatPrecision ? DirectX::XMVector3NormalizeEst(bSum) : emptyVector;
-                        const DirectX::XMVECTOR n = DirectX::XMVector3NormalizeEst(nSum);
+                            DirectX::XMVECTOR nSum = emptyVector;
+                            DirectX::XMVECTOR tSum = emptyVector;
+                            DirectX::XMVECTOR bSum = emptyVector;
 
-                        if (!DirectX::XMVector3Equal(t, emptyVector))
-                        {
-                            t = DirectX::XMVector3NormalizeEst(DirectX::XMVectorSubtract(t, DirectX::XMVectorScale(n, DirectX::XMVectorGetX(DirectX::XMVector3Dot(n, t)))));
-                            b = DirectX::XMVector3NormalizeEst(DirectX::XMVector3Cross(n, t));
+                            const std::uint32_t ci = weldCluster[i];
+                            for (std::uint32_t c = clusterFaceOffsets[ci]; c < clusterFaceOffsets[ci + 1]; c++)
+                            {
+                                const std::uint32_t fi = clusterFaces[c];
+                                DirectX::XMVECTOR fnVec = faceNormals.Get(fi);
+                                DirectX::XMVECTOR dot = DirectX::XMVector3Dot(fnVec, nSelf);
+                                if constexpr (invert)
+                                {
+                                    const DirectX::XMVECTOR negative = DirectX::XMVectorLess(dot, emptyVector);
+                                    dot = DirectX::XMVectorSelect(dot, DirectX::XMVectorNegate(dot), negative);
+                                    fnVec = DirectX::XMVectorSelect(fnVec, DirectX::XMVectorNegate(fnVec), negative);
+                                }
+                                DirectX::XMVECTOR tVec = faceTangents.Get(fi);
+                                DirectX::XMVECTOR bVec = faceBitangents.Get(fi);
+                                if constexpr (weighted)
+                                {
+                                    const float weight = clusterFaceWeights[c];
+                                    fnVec = DirectX::XMVectorScale(fnVec, weight);
+                                    tVec = DirectX::XMVectorScale(tVec, weight);
+                                    bVec = DirectX::XMVectorScale(bVec, weight);
+                                }
+                                const DirectX::XMVECTOR outside = DirectX::XMVectorLess(dot, smoothCosV);
+                                nSum = DirectX::XMVectorSelect(DirectX::XMVectorAdd(nSum, fnVec), nSum, outside);
+                                tSum = DirectX::XMVectorSelect(DirectX::XMVectorAdd(tSum, tVec), tSum, outside);
+                                bSum = DirectX::XMVectorSelect(DirectX::XMVectorAdd(bSum, bVec), bSum, outside);
+                            }
+
+                            if (DirectX::XMVector3Equal(nSum, emptyVector))
+                                continue;
+
+                            nSums.Set(i, nSum);
+                            tSums.Set(i, tSum);
+                            bSums.Set(i, bSum);
+                            valid[i] = UINT32_MAX;
                         }
+                    },
+                    tbb::auto_partitioner()
+                );
+            });
+        };
+        if (allowInvertNormalSmooth)
+        {
+            if (angleWeighted)
+                gather.template operator()<true, true>();
+            else
+                gather.template operator()<true, false>();
+        }
+        else
+        {
+            if (angleWeighted)
+                gather.template operator()<false, true>();
+            else
+                gather.template operator()<false, false>();
+        }
 
-                        if (!DirectX::XMVector3Equal(t, emptyVector))
-                            DirectX::XMStoreFloat3(&tangents[i], t);
-                        if (!DirectX::XMVector3Equal(b, emptyVector))
-                            DirectX::XMStoreFloat3(&bitangents[i], b);
-                        DirectX::XMStoreFloat3(&normals[i], n);
-                    }
+        GeometryKernel::Float3Planes normalPlanes, tangentPlanes, bitangentPlanes;
+        normalPlanes.Load(normals, tp.get());
+        tangentPlanes.Load(tangents, tp.get());
+        bitangentPlanes.Load(bitangents, tp.get());
+        tp->Execute([&] {
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>(0, GeometryKernel::BlockCount(vertCount)),
+                [&](const tbb::blocked_range<std::size_t>& r) {
+                    GeometryKernel::FinalizeVertexBasis(nSums, tSums, bSums, valid, r.begin(), r.end(),
+                                                        normalPlanes, tangentPlanes, bitangentPlanes);
                 },
                 tbb::auto_partitioner()
             );
         });
+        normalPlanes.Store(normals, tp.get());
+        tangentPlanes.Store(tangents, tp.get());
+        bitangentPlanes.Store(bitangents, tp.get());
+        if (Config::GetSingleton().GetTangentSpace() == Config::TangentSpaceList::MikkTSpace)
+            RecalculateMikkTSpaceTangents();
 
 		if (Config::GetSingleton().GetGeometryDataTime())
 			PerformanceLog(std::string(__func__) + "::" + std::to_string(normals.size()), true, false);
@@ -562,7 +849,107 @@ namespace Mus {
 		return;
 	}
 
-	void GeometryData::Subdivision(std::uint32_t a_subCount, std::uint32_t a_triThreshold, float a_strength, std::uint32_t a_smoothCount, bool weldAccuracy)
+	void GeometryData::RecalculateMikkTSpaceTangents()
+	{
+        const std::size_t vertCount = vertices.size();
+        const std::size_t triCount = indices.size() / 3;
+        if (Config::GetSingleton().GetGeometryDataTime())
+            PerformanceLog(std::string(__func__) + "::" + std::to_string(vertCount), false, false);
+
+        // unit face tangent with the uv winding sign, and the uv winding itself
+        // same as MikkTSpace vOs, faces with a degenerated uv area get a zero tangent
+        GeometryKernel::Float3Planes faceDirs;
+        faceDirs.Resize(triCount);
+        std::pmr::vector<std::uint8_t> faceFlipped(triCount, 0, arena->Get());
+        tp->Execute([&] {
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>(0, triCount),
+                [&](const tbb::blocked_range<std::size_t>& r) {
+                    for (std::size_t fi = r.begin(); fi != r.end(); ++fi)
+                    {
+                        const std::uint32_t i0 = facePlanes.i0[fi];
+                        const std::uint32_t i1 = facePlanes.i1[fi];
+                        const std::uint32_t i2 = facePlanes.i2[fi];
+                        const DirectX::XMVECTOR p0 = DirectX::XMLoadFloat3(&vertices[i0]);
+                        const DirectX::XMVECTOR d1 = DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&vertices[i1]), p0);
+                        const DirectX::XMVECTOR d2 = DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&vertices[i2]), p0);
+                        const float st1x = uvs[i1].x - uvs[i0].x, st1y = uvs[i1].y - uvs[i0].y;
+                        const float st2x = uvs[i2].x - uvs[i0].x, st2y = uvs[i2].y - uvs[i0].y;
+                        const float signedArea = st1x * st2y - st1y * st2x;
+                        faceFlipped[fi] = signedArea < 0.0f;
+                        if (std::fabs(signedArea) < floatPrecision * floatPrecision)
+                            continue;
+                        const DirectX::XMVECTOR os = DirectX::XMVectorSubtract(DirectX::XMVectorScale(d1, st2y), DirectX::XMVectorScale(d2, st1y));
+                        const float lenSq = DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(os));
+                        if (lenSq < floatPrecision * floatPrecision)
+                            continue;
+                        faceDirs.Set(fi, DirectX::XMVectorScale(os, (signedArea < 0.0f ? -1.0f : 1.0f) / std::sqrtf(lenSq)));
+                    }
+                },
+                tbb::auto_partitioner()
+            );
+        });
+
+        // a MikkTSpace vertex is every welded link with the same uv
+        // each corner adds its face tangent projected on the vertex normal, weighted by the corner angle in that plane
+        // corners are split by uv winding in MikkTSpace, here the winding with the larger angle wins the vertex
+        tp->Execute([&] {
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>(0, vertCount),
+                [&](const tbb::blocked_range<std::size_t>& r) {
+                    for (std::size_t i = r.begin(); i != r.end(); ++i)
+                    {
+                        const DirectX::XMVECTOR n = DirectX::XMLoadFloat3(&normals[i]);
+                        if (DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(n)) < floatPrecision)
+                            continue;
+                        auto project = [&](DirectX::FXMVECTOR v) {
+                            return DirectX::XMVectorSubtract(v, DirectX::XMVectorScale(n, DirectX::XMVectorGetX(DirectX::XMVector3Dot(n, v))));
+                        };
+
+                        DirectX::XMVECTOR tSum[2] = {emptyVector, emptyVector};
+                        float angleSum[2] = {0.0f, 0.0f};
+                        for (const auto& link : GetWeldedVertices(i))
+                        {
+                            if (uvs[link].x != uvs[i].x || uvs[link].y != uvs[i].y)
+                                continue;
+                            for (const auto& fi : vertexToFaceMap[link])
+                            {
+                                const DirectX::XMVECTOR dir = faceDirs.Get(fi);
+                                if (DirectX::XMVector3Equal(dir, emptyVector))
+                                    continue;
+                                const std::uint32_t corner[3] = {facePlanes.i0[fi], facePlanes.i1[fi], facePlanes.i2[fi]};
+                                const std::uint32_t k = corner[0] == link ? 0 : (corner[1] == link ? 1 : 2);
+                                const DirectX::XMVECTOR p = DirectX::XMLoadFloat3(&vertices[link]);
+                                const DirectX::XMVECTOR e1 = DirectX::XMVector3Normalize(project(DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&vertices[corner[(k + 1) % 3]]), p)));
+                                const DirectX::XMVECTOR e2 = DirectX::XMVector3Normalize(project(DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&vertices[corner[(k + 2) % 3]]), p)));
+                                const float angle = std::acosf(std::clamp(DirectX::XMVectorGetX(DirectX::XMVector3Dot(e1, e2)), -1.0f, 1.0f));
+                                const DirectX::XMVECTOR t = project(dir);
+                                if (DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(t)) < floatPrecision * floatPrecision)
+                                    continue;
+                                const std::uint8_t flipped = faceFlipped[fi];
+                                tSum[flipped] = DirectX::XMVectorAdd(tSum[flipped], DirectX::XMVectorScale(DirectX::XMVector3Normalize(t), angle));
+                                angleSum[flipped] += angle;
+                            }
+                        }
+
+                        const std::uint8_t flipped = angleSum[1] > angleSum[0] ? 1 : 0;
+                        if (DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(tSum[flipped])) < floatPrecision * floatPrecision)
+                            continue;
+                        const DirectX::XMVECTOR t = DirectX::XMVector3Normalize(tSum[flipped]);
+                        const DirectX::XMVECTOR b = DirectX::XMVectorScale(DirectX::XMVector3Cross(n, t), flipped ? -1.0f : 1.0f);
+                        DirectX::XMStoreFloat3(&tangents[i], t);
+                        DirectX::XMStoreFloat3(&bitangents[i], b);
+                    }
+                },
+                tbb::auto_partitioner()
+            );
+        });
+
+        if (Config::GetSingleton().GetGeometryDataTime())
+            PerformanceLog(std::string(__func__) + "::" + std::to_string(vertCount), true, false);
+	}
+
+	void GeometryData::Subdivision(std::uint32_t a_subCount, std::uint32_t a_triThreshold, bool a_adaptive, float a_texelThreshold, float a_angleThreshold, float a_strength, std::uint32_t a_smoothCount, bool weldAccuracy)
     {
         if (a_subCount == 0)
             return;
@@ -575,9 +962,108 @@ namespace Mus {
             orgTriCount[gi] = geometries[gi].objInfo.indicesCount() / 3;
         }
 
-        auto doSubdivision = [&]() {
-            std::vector<LocalDate> subdividedDatas(geometries.size());
-            std::vector<std::uint32_t> beforeVertexStart(geometries.size());
+        const float maxDihedralCos = std::cosf(a_angleThreshold * toRadian);
+        auto doSubdivision = [&](SubdivisionTopology* record) {
+            std::vector<LocalDate> subdividedDatas(geometries.size());
+            std::vector<std::uint32_t> beforeVertexStart(geometries.size());
+
+            // select faces to split, every face in uniform mode
+            // adaptive mode takes faces whose uv footprint covers too many texels or which fold too much against a neighbour
+            const std::size_t faceCount = indices.size() / 3;
+            std::pmr::vector<std::uint8_t> splitFace(faceCount, 0, arena->Get());
+            for (std::size_t gi = 0; gi < geometries.size(); gi++)
+            {
+                if (orgTriCount[gi] / 3 > a_triThreshold)
+                    continue;
+                const std::size_t faceStart = geometries[gi].objInfo.indicesStart / 3;
+                const std::size_t faceEnd = geometries[gi].objInfo.indicesEnd / 3;
+                const float texelArea = GetBakeTexelArea(gi);
+                tp->Execute([&] {
+                    tbb::parallel_for(
+                        tbb::blocked_range<std::size_t>(faceStart, faceEnd),
+                        [&](const tbb::blocked_range<std::size_t>& r) {
+                            for (std::size_t fi = r.begin(); fi != r.end(); ++fi)
+                            {
+                                if (!a_adaptive)
+                                {
+                                    splitFace[fi] = 1;
+                                    continue;
+                                }
+                                const std::uint32_t i0 = facePlanes.i0[fi];
+                                const std::uint32_t i1 = facePlanes.i1[fi];
+                                const std::uint32_t i2 = facePlanes.i2[fi];
+                                if (i0 < uvs.size() && i1 < uvs.size() && i2 < uvs.size())
+                                {
+                                    const float du1 = uvs[i1].x - uvs[i0].x;
+                                    const float dv1 = uvs[i1].y - uvs[i0].y;
+                                    const float du2 = uvs[i2].x - uvs[i0].x;
+                                    const float dv2 = uvs[i2].y - uvs[i0].y;
+                                    const float texels = std::fabs(du1 * dv2 - du2 * dv1) * 0.5f * texelArea;
+                                    if (texels > a_texelThreshold)
+                                    {
+                                        splitFace[fi] = 1;
+                                        continue;
+                                    }
+                                }
+                                if (a_angleThreshold < floatPrecision)
+                                    continue;
+                                const DirectX::XMVECTOR n = faceNormals.Get(fi);
+                                if (DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(n)) < floatPrecision)
+                                    continue;
+                                for (std::uint32_t corner = 0; corner < 3 && !splitFace[fi]; corner++)
+                                {
+                                    const std::uint32_t edge = edgeTable.Edge(fi, corner);
+                                    if (edge == GeometryKernel::EdgeTable::invalid)
+                                        continue;
+                                    const std::uint32_t ev1 = edgeTable.v1[edge];
+                                    for (const auto& nfi : vertexToFaceMap[edgeTable.v0[edge]])
+                                    {
+                                        if (nfi == fi || (facePlanes.i0[nfi] != ev1 && facePlanes.i1[nfi] != ev1 && facePlanes.i2[nfi] != ev1))
+                                            continue;
+                                        const DirectX::XMVECTOR nn = faceNormals.Get(nfi);
+                                        if (DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(nn)) < floatPrecision)
+                                            continue;
+                                        if (DirectX::XMVectorGetX(DirectX::XMVector3Dot(n, nn)) < maxDihedralCos)
+                                        {
+                                            splitFace[fi] = 1;
+                                            break;
+                                        }
+                                    }
+                                }
+                            }
+                        },
+                        tbb::auto_partitioner()
+                    );
+                });
+            }
+
+            // an edge is split if any face using it is split, the faces around it then get a transition pattern
+            std::pmr::vector<std::uint8_t> splitEdge(edgeTable.size(), 0, arena->Get());
+            tp->Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, edgeTable.size()),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                        for (std::size_t e = r.begin(); e != r.end(); ++e)
+                        {
+                            if (!a_adaptive)
+                            {
+                                splitEdge[e] = splitFace[edgeTable.firstHalfEdge[e] / 3];
+                                continue;
+                            }
+                            const std::uint32_t ev1 = edgeTable.v1[e];
+                            for (const auto& fi : vertexToFaceMap[edgeTable.v0[e]])
+                            {
+                                if (splitFace[fi] && (facePlanes.i0[fi] == ev1 || facePlanes.i1[fi] == ev1 || facePlanes.i2[fi] == ev1))
+                                {
+                                    splitEdge[e] = 1;
+                                    break;
+                                }
+                            }
+                        }
+                    },
+                    tbb::auto_partitioner()
+                );
+            });
 
             // divide geo data
             for (std::size_t gi = 0; gi < geometries.size(); gi++)
@@ -624,84 +1110,172 @@ namespace Mus {
             uvs.clear();
             indices.clear();
 
-            // create tris
+            // create tris, a geometry never shares an edge with another one
+            // midpoints are numbered in order of the first face corner using their edge, so the result does not depend on the thread scheduling
             {
-                tp->Execute([&] {
-                    tbb::parallel_for(
-                        tbb::blocked_range<std::size_t>(0, subdividedDatas.size()),
-                        [&](const tbb::blocked_range<std::size_t>& r) {
-                            for (std::size_t gi = r.begin(); gi != r.end(); ++gi)
-                            {
-                                if (orgTriCount[gi] / 3 > a_triThreshold)
-                                    continue;
+                std::pmr::vector<std::uint32_t> midpointOfEdge(edgeTable.size(), GeometryKernel::EdgeTable::invalid, arena->Get());
+                for (std::size_t gi = 0; gi < subdividedDatas.size(); gi++)
+                {
+                    if (orgTriCount[gi] / 3 > a_triThreshold)
+                        continue;
+
+                    auto& data = subdividedDatas[gi];
+                    const std::size_t triCount = data.indices.size() / 3;
+                    const std::size_t halfEdgeCount = triCount * 3;
+                    const std::size_t halfEdgeStart = geometries[gi].objInfo.indicesStart / 3 * 3;
+                    const std::uint32_t oldVertexCount = data.vertices.size();
+                    auto isSplitHalfEdge = [&](std::size_t h) -> bool {
+                        const std::uint32_t edge = edgeTable.halfEdges[halfEdgeStart + h];
+                        return edge != GeometryKernel::EdgeTable::invalid && splitEdge[edge];
+                    };
+                    auto isFirstHalfEdge = [&](std::size_t h) -> bool {
+                        return isSplitHalfEdge(h) && edgeTable.firstHalfEdge[edgeTable.halfEdges[halfEdgeStart + h]] == halfEdgeStart + h;
+                    };
+
+                    // midpoint number of each first half edge
+                    std::pmr::vector<std::uint32_t> midpointRank(halfEdgeCount + 1, 0, arena->Get());
+                    tp->Execute([&] {
+                        tbb::parallel_scan(
+                            tbb::blocked_range<std::size_t>(0, halfEdgeCount),
+                            std::uint32_t(0),
+                            [&](const tbb::blocked_range<std::size_t>& r, std::uint32_t sum, bool isFinal) {
+                                for (std::size_t h = r.begin(); h != r.end(); ++h)
+                                {
+                                    if (isFinal)
+                                        midpointRank[h] = sum;
+                                    if (isFirstHalfEdge(h))
+                                        sum++;
+                                }
+                                if (isFinal && r.end() == halfEdgeCount)
+                                    midpointRank[halfEdgeCount] = sum;
+                                return sum;
+                            },
+                            std::plus<std::uint32_t>()
+                        );
+                    });
+                    const std::uint32_t midpointCount = midpointRank[halfEdgeCount];
+
+                    // first tri of each face, a face with n split edges becomes n + 1 tris
+                    std::pmr::vector<std::uint32_t> triStart(triCount + 1, 0, arena->Get());
+                    tp->Execute([&] {
+                        tbb::parallel_scan(
+                            tbb::blocked_range<std::size_t>(0, triCount),
+                            std::uint32_t(0),
+                            [&](const tbb::blocked_range<std::size_t>& r, std::uint32_t sum, bool isFinal) {
+                                for (std::size_t i = r.begin(); i != r.end(); ++i)
+                                {
+                                    if (isFinal)
+                                        triStart[i] = sum;
+                                    sum += 1 + isSplitHalfEdge(i * 3 + 0) + isSplitHalfEdge(i * 3 + 1) + isSplitHalfEdge(i * 3 + 2);
+                                }
+                                if (isFinal && r.end() == triCount)
+                                    triStart[triCount] = sum;
+                                return sum;
+                            },
+                            std::plus<std::uint32_t>()
+                        );
+                    });
+
+                    // create midpoints
+                    data.vertices.resize(oldVertexCount + midpointCount);
+                    data.uvs.resize(oldVertexCount + midpointCount);
+                    data.localCreatedEdges.resize(midpointCount);
+                    tp->Execute([&] {
+                        tbb::parallel_for(
+                            tbb::blocked_range<std::size_t>(0, halfEdgeCount),
+                            [&](const tbb::blocked_range<std::size_t>& r) {
+                                for (std::size_t h = r.begin(); h != r.end(); ++h)
+                                {
+                                    if (!isFirstHalfEdge(h))
+                                        continue;
+                                    const std::size_t offset = h - h % 3;
+                                    const std::uint32_t corner = h % 3;
+                                    const std::uint32_t i0 = data.indices[offset + (corner == 1 ? 1 : 0)];
+                                    const std::uint32_t i1 = data.indices[offset + (corner == 0 ? 1 : 2)];
+                                    const std::uint32_t index = oldVertexCount + midpointRank[h];
 
-                                auto& data = subdividedDatas[gi];
-                                data.vertices.reserve(data.vertices.size() + data.indices.size() / 3);
-                                data.uvs.reserve(data.uvs.size() + data.indices.size() / 3);
-                                data.localCreatedEdges.reserve(data.indices.size());
-                                std::unordered_map<std::size_t, std::uint32_t> midpointMap;
-                                auto getMidpointIndex = [&](const std::uint32_t i0, const std::uint32_t i1) -> std::uint32_t {
-                                    const auto key = Edge(i0, i1)();
-                                    if (auto it = midpointMap.find(key); it != midpointMap.end())
-                                        return it->second;
-
-                                    const std::uint32_t index = data.vertices.size();
                                     const auto& v0 = data.vertices[i0];
                                     const auto& v1 = data.vertices[i1];
-                                    const DirectX::XMFLOAT3 midVertex = {
+                                    data.vertices[index] = {
                                         (v0.x + v1.x) * 0.5f,
                                         (v0.y + v1.y) * 0.5f,
                                         (v0.z + v1.z) * 0.5f};
-                                    data.vertices.push_back(midVertex);
 
                                     const auto& u0 = data.uvs[i0];
                                     const auto& u1 = data.uvs[i1];
-                                    const DirectX::XMFLOAT2 midUV = {
+                                    data.uvs[index] = {
                                         (u0.x + u1.x) * 0.5f,
                                         (u0.y + u1.y) * 0.5f};
-                                    data.uvs.push_back(midUV);
 
-                                    midpointMap[key] = index;
-                                    data.localCreatedEdges.push_back({i0, i1, index});
-                                    return index;
-                                };
+                                    midpointOfEdge[edgeTable.halfEdges[halfEdgeStart + h]] = index;
+                                    data.localCreatedEdges[midpointRank[h]] = {i0, i1, index};
+                                }
+                            },
+                            tbb::auto_partitioner()
+                        );
+                    });
 
-                                const std::size_t oldIndicesCount = data.indices.size();
-                                auto oldIndices = data.indices;
-                                data.indices.resize(oldIndicesCount * 4);
-                                for (std::size_t i = 0; i < oldIndicesCount / 3; i++)
+                    // split faces
+                    const std::vector<std::uint32_t> oldIndices = std::move(data.indices);
+                    data.indices.resize(static_cast<std::size_t>(triStart[triCount]) * 3);
+                    tp->Execute([&] {
+                        tbb::parallel_for(
+                            tbb::blocked_range<std::size_t>(0, triCount),
+                            [&](const tbb::blocked_range<std::size_t>& r) {
+                                for (std::size_t i = r.begin(); i != r.end(); ++i)
                                 {
                                     const std::size_t offset = i * 3;
-                                    const std::uint32_t v0 = oldIndices[offset + 0];
-                                    const std::uint32_t v1 = oldIndices[offset + 1];
-                                    const std::uint32_t v2 = oldIndices[offset + 2];
-
-                                    const std::uint32_t m01 = getMidpointIndex(v0, v1);
-                                    const std::uint32_t m12 = getMidpointIndex(v1, v2);
-                                    const std::uint32_t m20 = getMidpointIndex(v0, v2);
-
-                                    const std::size_t triOffset = offset * 4;
-                                    data.indices[triOffset + 0] = v0;
-                                    data.indices[triOffset + 1] = m01;
-                                    data.indices[triOffset + 2] = m20;
-
-                                    data.indices[triOffset + 3] = v1;
-                                    data.indices[triOffset + 4] = m12;
-                                    data.indices[triOffset + 5] = m01;
-
-                                    data.indices[triOffset + 6] = v2;
-                                    data.indices[triOffset + 7] = m20;
-                                    data.indices[triOffset + 8] = m12;
-
-                                    data.indices[triOffset + 9] = m01;
-                                    data.indices[triOffset + 10] = m12;
-                                    data.indices[triOffset + 11] = m20;
+                                    const std::uint32_t v[3] = {oldIndices[offset + 0], oldIndices[offset + 1], oldIndices[offset + 2]};
+                                    // midpoint of v[k] - v[k + 1], invalid if not split
+                                    std::uint32_t m[3];
+                                    std::uint32_t splitCount = 0;
+                                    for (std::uint32_t corner = 0; corner < 3; corner++)
+                                    {
+                                        m[corner] = isSplitHalfEdge(offset + corner) ? midpointOfEdge[edgeTable.halfEdges[halfEdgeStart + offset + corner]] : GeometryKernel::EdgeTable::invalid;
+                                        splitCount += m[corner] != GeometryKernel::EdgeTable::invalid;
+                                    }
+
+                                    std::uint32_t* tri = data.indices.data() + static_cast<std::size_t>(triStart[i]) * 3;
+                                    auto addTri = [&](std::uint32_t a, std::uint32_t b, std::uint32_t c) {
+                                        tri[0] = a;
+                                        tri[1] = b;
+                                        tri[2] = c;
+                                        tri += 3;
+                                    };
+                                    if (splitCount == 3)
+                                    {
+                                        addTri(v[0], m[0], m[2]);
+                                        addTri(v[1], m[1], m[0]);
+                                        addTri(v[2], m[2], m[1]);
+                                        addTri(m[0], m[1], m[2]);
+                                    }
+                                    else if (splitCount == 2)
+                                    {
+                                        // k is the edge kept, split the opposite corner off and the remaining quad in two
+                                        const std::uint32_t k = m[0] == GeometryKernel::EdgeTable::invalid ? 0 : (m[1] == GeometryKernel::EdgeTable::invalid ? 1 : 2);
+                                        const std::uint32_t a = v[k], b = v[(k + 1) % 3], c = v[(k + 2) % 3];
+                                        const std::uint32_t mbc = m[(k + 1) % 3], mca = m[(k + 2) % 3];
+                                        addTri(c, mca, mbc);
+                                        addTri(a, b, mbc);
+                                        addTri(a, mbc, mca);
+                                    }
+                                    else if (splitCount == 1)
+                                    {
+                                        const std::uint32_t k = m[0] != GeometryKernel::EdgeTable::invalid ? 0 : (m[1] != GeometryKernel::EdgeTable::invalid ? 1 : 2);
+                                        const std::uint32_t a = v[k], b = v[(k + 1) % 3], c = v[(k + 2) % 3];
+                                        addTri(a, m[k], c);
+                                        addTri(m[k], b, c);
+                                    }
+                                    else
+                                    {
+                                        addTri(v[0], v[1], v[2]);
+                                    }
                                 }
-                            }
-                        },
-                        tbb::auto_partitioner()
-                    );
-                });
+                            },
+                            tbb::auto_partitioner()
+                        );
+                    });
+                }
             }
 
             // add vertex datas
@@ -753,33 +1327,38 @@ namespace Mus {
 
                 GeometriesInfo newGeoInfo = {
                     .geometry = data.geometry,
-                    .objInfo = data.objInfo};
+                    .objInfo = data.objInfo,
+                    .bakeWidth = geometries[gi].bakeWidth,
+                    .bakeHeight = geometries[gi].bakeHeight};
                 geometries[gi] = std::move(newGeoInfo);
             }
 
-            // fix original linked vertices data
-            auto linkedVertices_ = std::move(weldedVertices);
-            weldedVertices.resize(vertices.size());
+            // fix original weld clusters
+            // vertexGeometry still holds the ranges before subdivision here
+            std::pmr::vector<std::uint32_t> remap(weldCluster.size(), arena->Get());
+            tp->Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, remap.size()),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                        for (std::size_t i = r.begin(); i != r.end(); ++i)
+                        {
+                            const std::uint16_t gi = vertexGeometry[i];
+                            remap[i] = i - beforeVertexStart[gi] + geometries[gi].objInfo.vertexStart;
+                        }
+                    },
+                    tbb::auto_partitioner()
+                );
+            });
+            GeometryKernel::DisjointSet weldSet;
+            weldSet.Reset(vertices.size());
             {
-                std::size_t gi = 0;
-                const std::size_t bvsSize = beforeVertexStart.size();
-                for (std::size_t i = 0; i < linkedVertices_.size(); i++)
+                for (std::size_t ci = 0; ci < weldClusters.size(); ci++)
                 {
-                    while (gi < bvsSize - 1 && i >= beforeVertexStart[gi + 1])
-                    {
-                        gi++;
-                    }
-                    for (auto& vi : linkedVertices_[i])
+                    const auto members = weldClusters[ci];
+                    for (std::size_t m = 1; m < members.size(); m++)
                     {
-                        std::size_t giAlt = 0;
-                        while (giAlt < bvsSize - 1 && vi >= beforeVertexStart[giAlt + 1])
-                        {
-                            giAlt++;
-                        }
-                        vi = vi - beforeVertexStart[giAlt] + geometries[giAlt].objInfo.vertexStart;
+                        weldSet.Union(remap[members[0]], remap[members[m]]);
                     }
-                    const std::uint32_t ni = i - beforeVertexStart[gi] + geometries[gi].objInfo.vertexStart;
-                    weldedVertices[ni] = std::move(linkedVertices_[i]);
                 }
             }
 
@@ -795,9 +1374,7 @@ namespace Mus {
                     newEdges.push_back({edge.v0 + vertexStart, edge.v1 + vertexStart, edge.mv + vertexStart});
                 }
             }
-            tp->Execute([&] {
-                tbb::parallel_sort(newEdges);
-            });
+            parallel_sort(newEdges, tp.get());
 
             const std::size_t newEdgesCount = newEdges.size();
             std::vector<PosEntry> pMap;
@@ -830,8 +1407,7 @@ namespace Mus {
                                 for (std::size_t i = r.begin(); i != r.end(); ++i)
                                 {
                                     const auto vi = newEdges[i].mv;
-                                    pMap[i * 2 + 0] = PosEntry(MakeLowPositionKey(vertices[vi]), vi);
-                                    pMap[i * 2 + 1] = PosEntry(MakeHighPositionKey(vertices[vi]), vi);
+                                    pMap[i] = PosEntry(MakePositionKey(vertices[vi]), vi);
                                 }
                             },
                             tbb::auto_partitioner()
@@ -839,55 +1415,90 @@ namespace Mus {
                     });
                 }
             }
-            tp->Execute([&] {
-                tbb::parallel_sort(pMap);
-            });
-            if (weldAccuracy)
-                pMap.erase(std::unique(pMap.begin(), pMap.end()), pMap.end());
-            AddWeldVertices(pMap);
+            parallel_sort(pMap, tp.get());
+            AddWeldVertices(pMap, weldSet);
+            BuildWeldClusters(weldSet);
+
+            if (record)
             {
-                tp->Execute([&] {
-                    tbb::parallel_for(
-                        tbb::blocked_range<std::size_t>(0, newEdgesCount),
-                        [&](const tbb::blocked_range<std::size_t>& r) {
-                            for (std::size_t i = r.begin(); i != r.end(); ++i)
-                            {
-                                const auto vi = newEdges[i].mv;
-                                std::sort(weldedVertices[vi].begin(), weldedVertices[vi].end());
-                                weldedVertices[vi].erase(std::unique(weldedVertices[vi].begin(), weldedVertices[vi].end()), weldedVertices[vi].end());
-                            }
-                        },
-                        tbb::auto_partitioner()
-                    );
-                });
+                record->indices = indices;
+                record->uvs = uvs;
+                record->ranges.resize(geometries.size());
+                for (std::size_t gi = 0; gi < geometries.size(); gi++)
+                {
+                    const auto& objInfo = geometries[gi].objInfo;
+                    record->ranges[gi] = {
+                        .vertexStart = objInfo.vertexStart,
+                        .vertexEnd = objInfo.vertexEnd,
+                        .uvStart = objInfo.uvStart,
+                        .uvEnd = objInfo.uvEnd,
+                        .indicesStart = objInfo.indicesStart,
+                        .indicesEnd = objInfo.indicesEnd};
+                }
+                record->vertexRemap.assign(remap.begin(), remap.end());
+                record->midpoints = std::move(newEdges);
             }
         };
 
-        auto createVertexToFaceMap = [&](){
-            vertexToFaceMap.clear();
-            const std::size_t vertCount = vertices.size();
-            vertexToFaceMap.resize(vertCount);
-            const std::size_t triCount = indices.size() / 3;
+        // same result as doSubdivision, but only the vertex positions are calculated
+        auto loadSubdivision = [&](const SubdivisionTopology& cached) {
+            std::vector<DirectX::XMFLOAT3> newVertices(cached.topology.weldCluster.size());
+            const std::size_t oldVertCount = cached.vertexRemap.size();
             tp->Execute([&] {
                 tbb::parallel_for(
-                    tbb::blocked_range<std::size_t>(0, triCount),
+                    tbb::blocked_range<std::size_t>(0, oldVertCount),
                     [&](const tbb::blocked_range<std::size_t>& r) {
                         for (std::size_t i = r.begin(); i != r.end(); ++i)
                         {
-                            const std::size_t offset = i * 3;
-                            const std::uint32_t i0 = indices[offset + 0];
-                            const std::uint32_t i1 = indices[offset + 1];
-                            const std::uint32_t i2 = indices[offset + 2];
-                            if (i0 >= vertCount || i1 >= vertCount || i2 >= vertCount)
-                                continue;
-                            vertexToFaceMap[i0].push_back(i);
-                            vertexToFaceMap[i1].push_back(i);
-                            vertexToFaceMap[i2].push_back(i);
+                            newVertices[cached.vertexRemap[i]] = vertices[i];
+                        }
+                    },
+                    tbb::auto_partitioner()
+                );
+            });
+            const std::size_t midpointCount = cached.midpoints.size();
+            tp->Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, midpointCount),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                        for (std::size_t i = r.begin(); i != r.end(); ++i)
+                        {
+                            const auto& edge = cached.midpoints[i];
+                            const auto& v0 = newVertices[edge.v0];
+                            const auto& v1 = newVertices[edge.v1];
+                            newVertices[edge.mv] = {
+                                (v0.x + v1.x) * 0.5f,
+                                (v0.y + v1.y) * 0.5f,
+                                (v0.z + v1.z) * 0.5f};
                         }
                     },
                     tbb::auto_partitioner()
                 );
             });
+            vertices = std::move(newVertices);
+            uvs = cached.uvs;
+            indices = cached.indices;
+
+            for (std::size_t gi = 0; gi < geometries.size(); gi++)
+            {
+                const auto& range = cached.ranges[gi];
+                ObjectInfo objInfo;
+                objInfo.info = geometries[gi].objInfo.info;
+                objInfo.vertexStart = range.vertexStart;
+                objInfo.vertexEnd = range.vertexEnd;
+                objInfo.uvStart = range.uvStart;
+                objInfo.uvEnd = range.uvEnd;
+                objInfo.indicesStart = range.indicesStart;
+                objInfo.indicesEnd = range.indicesEnd;
+
+                GeometriesInfo newGeoInfo = {
+                    .geometry = geometries[gi].geometry,
+                    .objInfo = std::move(objInfo),
+                    .bakeWidth = geometries[gi].bakeWidth,
+                    .bakeHeight = geometries[gi].bakeHeight};
+                geometries[gi] = std::move(newGeoInfo);
+            }
+            LoadTopology(cached.topology);
         };
 
         for (std::uint32_t i = 1; i <= a_subCount; i++)
@@ -895,8 +1506,30 @@ namespace Mus {
             const std::string subID = std::to_string(vertices.size());
             if (Config::GetSingleton().GetGeometryDataTime())
                 PerformanceLog(std::string(__func__) + "::" + subID + "::" + std::to_string(i), false, false);
-            doSubdivision();
-            createVertexToFaceMap();
+            const SubdivisionTopology* cached = nullptr;
+            // split by angle depends on the vertex positions, so it can't be cached
+            const bool cacheable = !a_adaptive || a_angleThreshold < floatPrecision;
+            if (cacheable && cachedTopology && cachedTopology->subdivisions.size() >= i)
+            {
+                cached = &cachedTopology->subdivisions[i - 1];
+                if (cached->vertexRemap.size() != vertices.size() || cached->ranges.size() != geometries.size())
+                    cached = nullptr;
+            }
+            if (cached)
+            {
+                loadSubdivision(*cached);
+            }
+            else
+            {
+                SubdivisionTopology* record = newTopology && cacheable ? &newTopology->subdivisions.emplace_back() : nullptr;
+                doSubdivision(record);
+                vertexToFaceMap.Build(vertices.size(), indices, 3, tp.get());
+                edgeTable.Build(indices, vertices.size(), tp.get());
+                if (record)
+                    SaveTopology(record->topology);
+            }
+            BuildVertexGeometry();
+            UpdateFacePlanes();
             if (Config::GetSingleton().GetGeometryDataTime())
                 PerformanceLog(std::string(__func__) + "::" + subID + "::" + std::to_string(i), true, false);
             CreateFaceData();
@@ -917,46 +1550,16 @@ namespace Mus {
         const float deflate = std::clamp(a_strength, 0.0f, 1.0f);
         const float inflate = -(deflate + 0.03f);
 
-        std::vector<std::future<void>> processes;
-        auto doSmooth = [&](float weight) {
-            auto tempVertices = vertices;
-            processes.clear();
+        BuildOneRing();
+
+        // deflate writes vertices into smoothed, inflate writes them back, so no copy is needed
+        std::vector<DirectX::XMFLOAT3> smoothed(vertices.size());
+        auto doSmooth = [&](const std::vector<DirectX::XMFLOAT3>& src, float weight, std::vector<DirectX::XMFLOAT3>& dst) {
             tp->Execute([&] {
                 tbb::parallel_for(
-                    tbb::blocked_range<std::size_t>(0, vertices.size()),
+                    tbb::blocked_range<std::size_t>(0, src.size()),
                     [&](const tbb::blocked_range<std::size_t>& r) {
-                        for (std::size_t i = r.begin(); i != r.end(); ++i)
-                        {
-                            std::unordered_set<std::uint32_t> connectedVertices;
-                            for (const auto& link : weldedVertices[i])
-                            {
-                                for (const auto& fi : vertexToFaceMap[link])
-                                {
-                                    const auto& fn = faceNormals[fi];
-                                    if (fn.v0 != link)
-                                        connectedVertices.insert(fn.v0);
-                                    if (fn.v1 != link)
-                                        connectedVertices.insert(fn.v1);
-                                    if (fn.v2 != link)
-                                        connectedVertices.insert(fn.v2);
-                                }
-                            }
-                            if (connectedVertices.empty())
-                                continue;
-
-                            DirectX::XMVECTOR sumPos = emptyVector;
-                            for (const auto& cvi : connectedVertices)
-                            {
-                                sumPos = DirectX::XMVectorAdd(sumPos, DirectX::XMLoadFloat3(&tempVertices[cvi]));
-                            }
-
-                            const DirectX::XMVECTOR avgPos = DirectX::XMVectorScale(sumPos, 1.0f / connectedVertices.size());
-                            const DirectX::XMVECTOR original = DirectX::XMLoadFloat3(&tempVertices[i]);
-                            const DirectX::XMVECTOR delta = DirectX::XMVectorSubtract(avgPos, original);
-                            const DirectX::XMVECTOR smoothed = DirectX::XMVectorAdd(original, DirectX::XMVectorScale(delta, weight));
-
-                            DirectX::XMStoreFloat3(&vertices[i], smoothed);
-                        }
+                        GeometryKernel::LaplacianSmooth(oneRing, src, weight, r.begin(), r.end(), dst);
                     },
                     tbb::auto_partitioner()
                 );
@@ -967,17 +1570,69 @@ namespace Mus {
         {
             if (Config::GetSingleton().GetGeometryDataTime())
                 PerformanceLog(std::string(__func__) + "::" + std::to_string(vertices.size()) + "::" + std::to_string(i), false, false);
-            doSmooth(deflate);
-            doSmooth(inflate);
+            doSmooth(vertices, deflate, smoothed);
+            doSmooth(smoothed, inflate, vertices);
             if (Config::GetSingleton().GetGeometryDataTime())
                 PerformanceLog(std::string(__func__) + "::" + std::to_string(vertices.size()) + "::" + std::to_string(i), true, false);
-            CreateFaceData();
         }
+        CreateFaceData();
 
 		logger::debug("{} : {} vertex smooth done", __func__, vertices.size());
 		return;
 	}
 
+	void GeometryData::BuildOneRing()
+	{
+        const std::size_t vertCount = vertices.size();
+        // neighbors of every welded link, without the links themselves
+        auto gatherRing = [&](std::size_t i, std::pmr::vector<std::uint32_t>& ring) {
+            ring.clear();
+            for (const auto& link : GetWeldedVertices(i))
+            {
+                for (const auto& e : edgeTable.vertexEdges[link])
+                {
+                    const std::uint32_t cvi = edgeTable.Other(e, link);
+                    if (cvi != link)
+                        ring.push_back(cvi);
+                }
+            }
+            std::sort(ring.begin(), ring.end());
+            ring.erase(std::unique(ring.begin(), ring.end()), ring.end());
+        };
+
+        oneRing.offsets.assign(vertCount + 1, 0);
+        tp->Execute([&] {
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>(0, vertCount),
+                [&](const tbb::blocked_range<std::size_t>& r) {
+                    std::pmr::vector<std::uint32_t> ring(arena->Get());
+                    for (std::size_t i = r.begin(); i != r.end(); ++i)
+                    {
+                        gatherRing(i, ring);
+                        oneRing.offsets[i + 1] = ring.size();
+                    }
+                },
+                tbb::auto_partitioner()
+            );
+        });
+        std::partial_sum(oneRing.offsets.begin(), oneRing.offsets.end(), oneRing.offsets.begin());
+        oneRing.items.resize(oneRing.offsets[vertCount]);
+        tp->Execute([&] {
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>(0, vertCount),
+                [&](const tbb::blocked_range<std::size_t>& r) {
+                    std::pmr::vector<std::uint32_t> ring(arena->Get());
+                    for (std::size_t i = r.begin(); i != r.end(); ++i)
+                    {
+                        gatherRing(i, ring);
+                        std::copy(ring.begin(), ring.end(), oneRing.items.begin() + oneRing.offsets[i]);
+                    }
+                },
+                tbb::auto_partitioner()
+            );
+        });
+	}
+
 	void GeometryData::VertexSmoothByAngle(float a_smoothThreshold1, float a_smoothThreshold2, std::uint32_t a_smoothCount)
 	{
 		if (vertices.empty() || a_smoothCount == 0)
@@ -989,49 +1644,56 @@ namespace Mus {
         const float maxCos = std::cosf(a_smoothThreshold1 * toRadian);
         const float minCos = std::cosf(a_smoothThreshold2 * toRadian);
 
+        std::pmr::vector<std::uint8_t> movedVertices(vertices.size(), 0, arena->Get());
         auto doSmooth = [&]() {
             const auto tempVertices = vertices;
+            std::fill(movedVertices.begin(), movedVertices.end(), 0);
             tp->Execute([&] {
                 tbb::parallel_for(
                     tbb::blocked_range<std::size_t>(0, vertices.size()),
                     [&](const tbb::blocked_range<std::size_t>& r) {
+                        std::pmr::vector<std::uint32_t> connectedVertices(arena->Get());
                         for (std::size_t i = r.begin(); i != r.end(); ++i)
                         {
                             DirectX::XMVECTOR nSelf = emptyVector;
-                            for (const auto& link : weldedVertices[i])
+                            for (const auto& link : GetWeldedVertices(i))
                             {
                                 for (const auto& fi : vertexToFaceMap[link])
                                 {
-                                    nSelf = DirectX::XMVectorAdd(nSelf, DirectX::XMLoadFloat3(&faceNormals[fi].normal));
+                                    nSelf = DirectX::XMVectorAdd(nSelf, faceNormals.Get(fi));
                                 }
                             }
                             if (DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(nSelf)) < floatPrecision)
                                 continue;
                             nSelf = DirectX::XMVector3NormalizeEst(nSelf);
 
-                            std::unordered_set<std::uint32_t> connectedVertices;
+                            connectedVertices.clear();
                             float dotTotal = 0.0f;
                             std::uint32_t dotCount = 0;
-                            for (const auto& link : weldedVertices[i])
+                            for (const auto& link : GetWeldedVertices(i))
                             {
                                 for (const auto& fi : vertexToFaceMap[link])
                                 {
-                                    const auto& fn = faceNormals[fi];
-                                    const float dot = DirectX::XMVectorGetX(DirectX::XMVector3Dot(nSelf, DirectX::XMLoadFloat3(&fn.normal)));
+                                    const float dot = DirectX::XMVectorGetX(DirectX::XMVector3Dot(nSelf, faceNormals.Get(fi)));
                                     if (dot > maxCos)
                                         continue;
-                                    if (fn.v0 != link)
-                                        connectedVertices.insert(fn.v0);
-                                    if (fn.v1 != link)
-                                        connectedVertices.insert(fn.v1);
-                                    if (fn.v2 != link)
-                                        connectedVertices.insert(fn.v2);
+                                    const std::uint32_t v0 = facePlanes.i0[fi];
+                                    const std::uint32_t v1 = facePlanes.i1[fi];
+                                    const std::uint32_t v2 = facePlanes.i2[fi];
+                                    if (v0 != link)
+                                        connectedVertices.push_back(v0);
+                                    if (v1 != link)
+                                        connectedVertices.push_back(v1);
+                                    if (v2 != link)
+                                        connectedVertices.push_back(v2);
                                     dotTotal += dot;
                                     dotCount++;
                                 }
                             }
                             if (connectedVertices.empty())
                                 continue;
+                            std::sort(connectedVertices.begin(), connectedVertices.end());
+                            connectedVertices.erase(std::unique(connectedVertices.begin(), connectedVertices.end()), connectedVertices.end());
 
                             DirectX::XMVECTOR avgPos = emptyVector;
                             const float avgDot = dotTotal / dotCount;
@@ -1044,6 +1706,7 @@ namespace Mus {
                             const DirectX::XMVECTOR original = DirectX::XMLoadFloat3(&tempVertices[i]);
                             const DirectX::XMVECTOR smoothed = DirectX::XMVectorLerp(original, avgPos, strength);
                             DirectX::XMStoreFloat3(&vertices[i], smoothed);
+                            movedVertices[i] = vertices[i].x != tempVertices[i].x || vertices[i].y != tempVertices[i].y || vertices[i].z != tempVertices[i].z;
                         }
                     },
                     tbb::auto_partitioner()
@@ -1057,7 +1720,7 @@ namespace Mus {
             doSmooth();
 			if (Config::GetSingleton().GetGeometryDataTime())
                 PerformanceLog(std::string(__func__) + "::" + std::to_string(vertices.size()) + "::" + std::to_string(i), true, false);
-            CreateFaceData();
+            UpdateFaceData(movedVertices);
         }
 	}
 
@@ -1081,10 +1744,27 @@ namespace Mus {
     {
         if (Config::GetSingleton().GetGeometryDataTime())
             PerformanceLog(std::string(__func__) + "::" + mainInfo.name, false, false);
+        cachedTopology = nullptr;
+        newTopology = nullptr;
+        if (Config::GetSingleton().GetTopologyCacheSize() > 0)
+        {
+            topologyHash = GetTopologyHash(Config::GetSingleton().GetSubdivision(), Config::GetSingleton().GetSubdivisionTriThreshold(), Config::GetSingleton().GetWeldAccuracy());
+            cachedTopology = TopologyCache::GetSingleton().Get(topologyHash);
+            if (!cachedTopology)
+                newTopology = std::make_shared<TopologyCacheData>();
+        }
         PreProcessing(Config::GetSingleton().GetWeldAccuracy());
         Subdivision(Config::GetSingleton().GetSubdivision(), Config::GetSingleton().GetSubdivisionTriThreshold(),
+                    Config::GetSingleton().GetSubdivisionAdaptive(), Config::GetSingleton().GetSubdivisionTexelThreshold(), Config::GetSingleton().GetSubdivisionAngleThreshold(),
                     Config::GetSingleton().GetSubdivisionVertexSmoothStrength(), Config::GetSingleton().GetSubdivisionVertexSmooth(), 
                     Config::GetSingleton().GetWeldAccuracy());
+        // split by angle depends on the vertex positions, same as in the subdivision cache
+        BuildBakeOrder(Config::GetSingleton().GetSubdivision() == 0 || !Config::GetSingleton().GetSubdivisionAdaptive()
+                       || Config::GetSingleton().GetSubdivisionAngleThreshold() < floatPrecision);
+        if (newTopology)
+            TopologyCache::GetSingleton().Insert(topologyHash, newTopology);
+        cachedTopology = nullptr;
+        newTopology = nullptr;
         VertexSmoothByAngle(Config::GetSingleton().GetVertexSmoothByAngleThreshold1(), Config::GetSingleton().GetVertexSmoothByAngleThreshold2(), Config::GetSingleton().GetVertexSmoothByAngle());
         VertexSmooth(Config::GetSingleton().GetVertexSmoothStrength(), Config::GetSingleton().GetVertexSmooth());
         RecalculateNormals(Config::GetSingleton().GetNormalSmoothDegree());
@@ -1093,6 +1773,44 @@ namespace Mus {
             PerformanceLog(std::string(__func__) + "::" + mainInfo.name, true, false);
     }
 
+    std::uint64_t GeometryData::GetTopologyHash(std::uint32_t a_subCount, std::uint32_t a_triThreshold, bool weldAccuracy) const
+    {
+        XXH3_state_t* state = XXH3_createState();
+        XXH3_64bits_reset(state);
+        XXH3_64bits_update(state, indices.data(), indices.size() * sizeof(std::uint32_t));
+        XXH3_64bits_update(state, uvs.data(), uvs.size() * sizeof(DirectX::XMFLOAT2));
+        for (const auto& geo : geometries)
+        {
+            const std::uint32_t ranges[3] = {geo.objInfo.vertexCount(), geo.objInfo.uvCount(), geo.objInfo.indicesCount()};
+            XXH3_64bits_update(state, ranges, sizeof(ranges));
+        }
+        const float weldDistance[2] = {Config::GetSingleton().GetWeldDistance(), Config::GetSingleton().GetBoundaryWeldDistance()};
+        XXH3_64bits_update(state, weldDistance, sizeof(weldDistance));
+        const std::uint32_t settings[4] = {a_subCount, a_triThreshold, weldAccuracy ? 1u : 0u, Config::GetSingleton().GetTriangleReorder() ? 1u : 0u};
+        XXH3_64bits_update(state, settings, sizeof(settings));
+        if (Config::GetSingleton().GetSubdivisionAdaptive())
+        {
+            const float adaptive[2] = {Config::GetSingleton().GetSubdivisionTexelThreshold(), Config::GetSingleton().GetSubdivisionAngleThreshold()};
+            XXH3_64bits_update(state, adaptive, sizeof(adaptive));
+            for (std::size_t gi = 0; gi < geometries.size(); gi++)
+            {
+                const float texelArea = GetBakeTexelArea(gi);
+                XXH3_64bits_update(state, &texelArea, sizeof(texelArea));
+            }
+        }
+        const std::uint64_t hash = XXH3_64bits_digest(state);
+        XXH3_freeState(state);
+        return hash;
+    }
+
+    float GeometryData::GetBakeTexelArea(std::size_t a_geometryIndex) const
+    {
+        const auto& geo = geometries[a_geometryIndex];
+        const std::uint32_t width = geo.bakeWidth > 0 ? geo.bakeWidth : Config::GetSingleton().GetTextureWidth();
+        const std::uint32_t height = geo.bakeHeight > 0 ? geo.bakeHeight : Config::GetSingleton().GetTextureHeight();
+        return static_cast<float>(width) * height;
+    }
+
     void GeometryData::ApplyNormals()
     {
         for (auto& geo : geometries)
@@ -1455,4 +2173,99 @@ namespace Mus {
         bool binary = filePath.ends_with(".glb");
         return gltf.WriteGltfSceneToFile(&model, filePath, false, false, true, binary);
     }
+
+    TopologyCache::TopologyCacheDataPtr TopologyCache::Get(std::uint64_t a_hash)
+    {
+        std::lock_guard lg(lock);
+        auto found = map.find(a_hash);
+        if (found == map.end())
+            return nullptr;
+        lru.splice(lru.begin(), lru, found->second.lruIt);
+        return found->second.data;
+    }
+
+    void TopologyCache::Insert(std::uint64_t a_hash, TopologyCacheDataPtr a_data)
+    {
+        const std::uint32_t cacheSize = Config::GetSingleton().GetTopologyCacheSize();
+        if (cacheSize == 0)
+            return;
+        std::lock_guard lg(lock);
+        if (auto found = map.find(a_hash); found != map.end())
+        {
+            found->second.data = a_data;
+            lru.splice(lru.begin(), lru, found->second.lruIt);
+            return;
+        }
+        lru.push_front(a_hash);
+        map[a_hash] = {a_data, lru.begin()};
+        while (map.size() > cacheSize)
+        {
+            map.erase(lru.back());
+            lru.pop_back();
+        }
+    }
+
+    void TopologyCache::Clear()
+    {
+        std::lock_guard lg(lock);
+        map.clear();
+        lru.clear();
+    }
+
+    GeometryDataPtr GeometryDataPool::Acquire(RE::FormID a_actorID, std::uint64_t a_layoutHash)
+    {
+        GeometryDataPtr data = nullptr;
+        {
+            std::lock_guard lg(lock);
+            if (auto found = map.find({a_actorID, a_layoutHash}); found != map.end())
+            {
+                data = std::move(found->second.data);
+                totalBytes -= found->second.bytes;
+                lru.erase(found->second.lruIt);
+                map.erase(found);
+            }
+        }
+        if (!data)
+            data = std::make_shared<GeometryData>();
+        data->poolLayoutHash = a_layoutHash;
+        return data;
+    }
+
+    void GeometryDataPool::Release(RE::FormID a_actorID, GeometryDataPtr a_data)
+    {
+        const std::size_t maxBytes = static_cast<std::size_t>(Config::GetSingleton().GetGeometryDataPoolSize()) * 1024 * 1024;
+        if (!a_data || maxBytes == 0)
+            return;
+        a_data->Clear();
+        const std::size_t bytes = a_data->GetMemoryUsage();
+        if (bytes > maxBytes)
+            return;
+
+        const PoolKey key = {a_actorID, a_data->poolLayoutHash};
+        std::lock_guard lg(lock);
+        if (auto found = map.find(key); found != map.end())
+        {
+            totalBytes -= found->second.bytes;
+            lru.erase(found->second.lruIt);
+            map.erase(found);
+        }
+        lru.push_front(key);
+        map[key] = {std::move(a_data), bytes, lru.begin()};
+        totalBytes += bytes;
+        while (totalBytes > maxBytes)
+        {
+            auto oldest = map.find(lru.back());
+            totalBytes -= oldest->second.bytes;
+            map.erase(oldest);
+            lru.pop_back();
+        }
+    }
+
+    void GeometryDataPool::Clear()
+    {
+        std::lock_guard lg(lock);
+        map.clear();
+        lru.clear();
+        totalBytes = 0;
+    }
 }
@@ -0,0 +1,968 @@
+#include "GeometryKernel.h"
+
+namespace Mus {
+    namespace GeometryKernel {
+        void AdjacencyList::Build(std::size_t keyCount, std::span<const std::uint32_t> keys, std::uint32_t divisor, TBB_ThreadPool* tp)
+        {
+            offsets.assign(keyCount + 1, 0);
+            items.clear();
+            if (keyCount == 0 || divisor == 0)
+                return;
+
+            // count
+            tp->Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, keys.size()),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                        for (std::size_t i = r.begin(); i != r.end(); ++i)
+                        {
+                            const std::uint32_t key = keys[i];
+                            if (key < keyCount)
+                                std::atomic_ref<std::uint32_t>(offsets[key + 1]).fetch_add(1, std::memory_order_relaxed);
+                        }
+                    },
+                    tbb::auto_partitioner()
+                );
+            });
+
+            // prefix sum
+            tp->Execute([&] {
+                tbb::parallel_scan(
+                    tbb::blocked_range<std::size_t>(0, offsets.size()),
+                    std::uint32_t(0),
+                    [&](const tbb::blocked_range<std::size_t>& r, std::uint32_t sum, bool isFinal) {
+                        for (std::size_t i = r.begin(); i != r.end(); ++i)
+                        {
+                            sum += offsets[i];
+                            if (isFinal)
+                                offsets[i] = sum;
+                        }
+                        return sum;
+                    },
+                    std::plus<std::uint32_t>()
+                );
+            });
+
+            // scatter
+            items.resize(offsets[keyCount]);
+            std::vector<std::uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+            tp->Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, keys.size()),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                        for (std::size_t i = r.begin(); i != r.end(); ++i)
+                        {
+                            const std::uint32_t key = keys[i];
+                            if (key >= keyCount)
+                                continue;
+                            const std::uint32_t pos = std::atomic_ref<std::uint32_t>(cursor[key]).fetch_add(1, std::memory_order_relaxed);
+                            items[pos] = static_cast<std::uint32_t>(i / divisor);
+                        }
+                    },
+                    tbb::auto_partitioner()
+                );
+            });
+            tp->Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, keyCount),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                        for (std::size_t i = r.begin(); i != r.end(); ++i)
+                        {
+                            std::sort(items.begin() + offsets[i], items.begin() + offsets[i + 1]);
+                        }
+                    },
+                    tbb::auto_partitioner()
+                );
+            });
+        }
+        void AdjacencyList::Clear()
+        {
+            offsets.clear();
+            items.clear();
+        }
+
+        void DisjointSet::Reset(std::size_t n)
+        {
+            parent.resize(n);
+            std::iota(parent.begin(), parent.end(), 0);
+        }
+        std::uint32_t DisjointSet::Flatten(std::vector<std::uint32_t>& clusterOf)
+        {
+            clusterOf.resize(parent.size());
+            std::uint32_t clusterCount = 0;
+            for (std::uint32_t i = 0; i < parent.size(); i++)
+            {
+                const std::uint32_t root = Find(i);
+                clusterOf[i] = root == i ? clusterCount++ : clusterOf[root]; // root <= i, so it is already numbered
+            }
+            return clusterCount;
+        }
+
+        void WeldSeamPairs(std::vector<WeldPair>& pairs, const std::vector<DirectX::XMFLOAT3>& vertices,
+                           const std::vector<std::uint16_t>& vertexGeometry, DisjointSet& weldSet)
+        {
+            if (pairs.empty())
+                return;
+            for (auto& pair : pairs)
+            {
+                if (pair.v0 > pair.v1)
+                    std::swap(pair.v0, pair.v1);
+            }
+            auto DistanceSq = [&](const WeldPair& pair) {
+                const DirectX::XMVECTOR d = DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&vertices[pair.v0]), DirectX::XMLoadFloat3(&vertices[pair.v1]));
+                return DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(d));
+            };
+            std::sort(pairs.begin(), pairs.end(), [&](const WeldPair& a, const WeldPair& b) {
+                const float da = DistanceSq(a), db = DistanceSq(b);
+                if (da != db)
+                    return da < db;
+                return a.v0 != b.v0 ? a.v0 < b.v0 : a.v1 < b.v1;
+            });
+            pairs.erase(std::unique(pairs.begin(), pairs.end(), [](const WeldPair& a, const WeldPair& b) {
+                return a.v0 == b.v0 && a.v1 == b.v1;
+            }), pairs.end());
+
+            // the position clusters of each cluster per geometry, keyed by the current root
+            // the roots are still the position clusters here, the seam links start below
+            struct Member {
+                std::uint16_t geometry;
+                std::uint32_t positionRoot;
+                bool operator==(const Member&) const = default;
+            };
+            std::unordered_map<std::uint32_t, std::vector<Member>> members;
+            for (const auto& pair : pairs)
+            {
+                for (const std::uint32_t v : {pair.v0, pair.v1})
+                {
+                    const std::uint32_t root = weldSet.Find(v);
+                    auto& list = members[root];
+                    const Member member = {vertexGeometry[v], root};
+                    if (std::find(list.begin(), list.end(), member) == list.end())
+                        list.push_back(member);
+                }
+            }
+
+            for (const auto& pair : pairs)
+            {
+                const std::uint32_t a = weldSet.Find(pair.v0);
+                const std::uint32_t b = weldSet.Find(pair.v1);
+                if (a == b)
+                    continue;
+                auto& membersA = members[a];
+                auto& membersB = members[b];
+                const bool conflict = std::any_of(membersA.begin(), membersA.end(), [&](const Member& ma) {
+                    return std::any_of(membersB.begin(), membersB.end(), [&](const Member& mb) {
+                        return ma.geometry == mb.geometry && ma.geometry != UINT16_MAX && ma.positionRoot != mb.positionRoot;
+                    });
+                });
+                if (conflict)
+                    continue;
+                weldSet.Union(a, b);
+                const std::uint32_t root = std::min(a, b);
+                auto& merged = root == a ? membersA : membersB;
+                auto& other = root == a ? membersB : membersA;
+                for (const auto& member : other)
+                {
+                    if (std::find(merged.begin(), merged.end(), member) == merged.end())
+                        merged.push_back(member);
+                }
+                members.erase(root == a ? b : a);
+            }
+        }
+
+        void EdgeTable::Build(const std::vector<std::uint32_t>& indices, std::size_t vertexCount, TBB_ThreadPool* tp)
+        {
+            Clear();
+            const std::size_t halfEdgeCount = indices.size() / 3 * 3;
+            halfEdges.assign(halfEdgeCount, invalid);
+            boundaryVertex.assign(vertexCount, 0);
+            if (halfEdgeCount == 0 || vertexCount == 0)
+                return;
+
+            // canonical endpoints of every half edge
+            std::vector<std::uint32_t> minKey(halfEdgeCount, invalid);
+            std::vector<std::uint32_t> maxKey(halfEdgeCount, invalid);
+            tp->Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, halfEdgeCount / 3),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                        for (std::size_t fi = r.begin(); fi != r.end(); ++fi)
+                        {
+                            const std::size_t offset = fi * 3;
+                            const std::uint32_t i0 = indices[offset + 0];
+                            const std::uint32_t i1 = indices[offset + 1];
+                            const std::uint32_t i2 = indices[offset + 2];
+                            if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount)
+                                continue;
+                            minKey[offset + 0] = std::min(i0, i1);
+                            maxKey[offset + 0] = std::max(i0, i1);
+                            minKey[offset + 1] = std::min(i1, i2);
+                            maxKey[offset + 1] = std::max(i1, i2);
+                            minKey[offset + 2] = std::min(i0, i2);
+                            maxKey[offset + 2] = std::max(i0, i2);
+                        }
+                    },
+                    tbb::auto_partitioner()
+                );
+            });
+
+            // group half edges by v0, then by v1 inside each group
+            AdjacencyList byMin;
+            byMin.Build(vertexCount, minKey, 1, tp);
+            std::vector<std::uint32_t> edgeOffsets(vertexCount + 1, 0);
+            tp->Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, vertexCount),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                        for (std::size_t v = r.begin(); v != r.end(); ++v)
+                        {
+                            const auto begin = byMin.items.begin() + byMin.offsets[v];
+                            const auto end = byMin.items.begin() + byMin.offsets[v + 1];
+                            std::sort(begin, end, [&](std::uint32_t a, std::uint32_t b) {
+                                return maxKey[a] != maxKey[b] ? maxKey[a] < maxKey[b] : a < b;
+                            });
+                            std::uint32_t count = 0;
+                            for (auto it = begin; it != end; ++it)
+                            {
+                                if (it == begin || maxKey[*it] != maxKey[*(it - 1)])
+                                    count++;
+                            }
+                            edgeOffsets[v + 1] = count;
+                        }
+                    },
+                    tbb::auto_partitioner()
+                );
+            });
+            tp->Execute([&] {
+                tbb::parallel_scan(
+                    tbb::blocked_range<std::size_t>(0, edgeOffsets.size()),
+                    std::uint32_t(0),
+                    [&](const tbb::blocked_range<std::size_t>& r, std::uint32_t sum, bool isFinal) {
+                        for (std::size_t i = r.begin(); i != r.end(); ++i)
+                        {
+                            sum += edgeOffsets[i];
+                            if (isFinal)
+                                edgeOffsets[i] = sum;
+                        }
+                        return sum;
+                    },
+                    std::plus<std::uint32_t>()
+                );
+            });
+
+            // assign edge ids
+            const std::size_t edgeCount = edgeOffsets[vertexCount];
+            v0.resize(edgeCount);
+            v1.resize(edgeCount);
+            faceCount.resize(edgeCount);
+            firstHalfEdge.resize(edgeCount);
+            tp->Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, vertexCount),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                        for (std::size_t v = r.begin(); v != r.end(); ++v)
+                        {
+                            const auto begin = byMin.items.begin() + byMin.offsets[v];
+                            const auto end = byMin.items.begin() + byMin.offsets[v + 1];
+                            std::uint32_t e = edgeOffsets[v] - 1;
+                            for (auto it = begin; it != end; ++it)
+                            {
+                                if (it == begin || maxKey[*it] != maxKey[*(it - 1)])
+                                {
+                                    e++;
+                                    v0[e] = static_cast<std::uint32_t>(v);
+                                    v1[e] = maxKey[*it];
+                                    faceCount[e] = 0;
+                                    firstHalfEdge[e] = *it;
+                                }
+                                faceCount[e]++;
+                                halfEdges[*it] = e;
+                            }
+                        }
+                    },
+                    tbb::auto_partitioner()
+                );
+            });
+
+            // vertex to edge map and boundary vertices
+            std::vector<std::uint32_t> endpoints(edgeCount * 2);
+            tp->Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, edgeCount),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                        for (std::size_t e = r.begin(); e != r.end(); ++e)
+                        {
+                            endpoints[e * 2 + 0] = v0[e];
+                            endpoints[e * 2 + 1] = v1[e];
+                        }
+                    },
+                    tbb::auto_partitioner()
+                );
+            });
+            vertexEdges.Build(vertexCount, endpoints, 2, tp);
+            tp->Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, vertexCount),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                        for (std::size_t v = r.begin(); v != r.end(); ++v)
+                        {
+                            for (const auto& e : vertexEdges[v])
+                            {
+                                if (faceCount[e] == 1)
+                                {
+                                    boundaryVertex[v] = 1;
+                                    break;
+                                }
+                            }
+                        }
+                    },
+                    tbb::auto_partitioner()
+                );
+            });
+        }
+        void EdgeTable::Clear()
+        {
+            v0.clear();
+            v1.clear();
+            faceCount.clear();
+            firstHalfEdge.clear();
+            halfEdges.clear();
+            boundaryVertex.clear();
+            vertexEdges.Clear();
+        }
+
+        namespace {
+            template <bool hasPosition, bool hasUV, bool f16c>
+            void DecodeVertices(const std::uint8_t* blocks, std::uint32_t vertexSize, std::size_t count,
+                                DirectX::XMFLOAT3* positions, DirectX::XMFLOAT2* uvs)
+            {
+                constexpr std::size_t uvOffset = hasPosition ? 16 : 0;
+                std::size_t i = 0;
+                if constexpr (hasUV && f16c)
+                {
+                    // u0 v0 u1 v1 ... as 8 halfs, so 4 vertices convert straight into the interleaved uvs
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        alignas(16) std::uint32_t packed[8];
+                        for (std::size_t k = 0; k < 8; k++)
+                        {
+                            const std::uint8_t* block = blocks + (i + k) * vertexSize;
+                            if constexpr (hasPosition)
+                                std::memcpy(&positions[i + k], block, sizeof(DirectX::XMFLOAT3));
+                            std::memcpy(&packed[k], block + uvOffset, sizeof(std::uint32_t));
+                        }
+                        const __m256 lo = _mm256_cvtph_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(packed)));
+                        const __m256 hi = _mm256_cvtph_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(packed + 4)));
+                        _mm256_storeu_ps(&uvs[i].x, _mm256_sub_ps(lo, _mm256_floor_ps(lo)));
+                        _mm256_storeu_ps(&uvs[i + 4].x, _mm256_sub_ps(hi, _mm256_floor_ps(hi)));
+                    }
+                }
+                for (; i < count; i++)
+                {
+                    const std::uint8_t* block = blocks + i * vertexSize;
+                    if constexpr (hasPosition)
+                        std::memcpy(&positions[i], block, sizeof(DirectX::XMFLOAT3));
+                    if constexpr (hasUV)
+                    {
+                        std::uint16_t half[2];
+                        std::memcpy(half, block + uvOffset, sizeof(half));
+                        uvs[i].x = DirectX::PackedVector::XMConvertHalfToFloat(half[0]);
+                        uvs[i].x -= std::floor(uvs[i].x);
+                        uvs[i].y = DirectX::PackedVector::XMConvertHalfToFloat(half[1]);
+                        uvs[i].y -= std::floor(uvs[i].y);
+                    }
+                }
+            }
+
+            template <bool f16c>
+            constexpr std::array<VertexDecoder, vertexFormatTotal> vertexDecoders = {
+                &DecodeVertices<false, false, f16c>,
+                &DecodeVertices<true, false, f16c>,
+                &DecodeVertices<false, true, f16c>,
+                &DecodeVertices<true, true, f16c>,
+            };
+        }
+
+        VertexDecoder GetVertexDecoder(std::uint32_t format)
+        {
+            format &= vertexFormatTotal - 1;
+            // every AVX2 cpu has F16C
+            if (GetSIMDType() == SIMDType::avx2)
+                return vertexDecoders<true>[format];
+            return vertexDecoders<false>[format];
+        }
+
+        namespace {
+            template <typename KeyFunc>
+            void BuildFaceOrder(std::size_t faceBegin, std::size_t faceEnd, std::vector<std::uint32_t>& order, TBB_ThreadPool* tp, KeyFunc&& getKey)
+            {
+                struct FaceKey {
+                    std::uint32_t key;
+                    std::uint32_t face;
+                };
+                if (faceBegin >= faceEnd)
+                    return;
+                std::vector<FaceKey> keys(faceEnd - faceBegin);
+                tp->Execute([&] {
+                    tbb::parallel_for(
+                        tbb::blocked_range<std::size_t>(faceBegin, faceEnd),
+                        [&](const tbb::blocked_range<std::size_t>& r) {
+                            for (std::size_t f = r.begin(); f != r.end(); ++f)
+                            {
+                                keys[f - faceBegin] = {getKey(f), static_cast<std::uint32_t>(f)};
+                            }
+                        },
+                        tbb::auto_partitioner()
+                    );
+                });
+                parallel_radix_sort(keys, [](const FaceKey& k) { return static_cast<std::uint64_t>(k.key); }, tp);
+                for (std::size_t i = 0; i < keys.size(); i++)
+                {
+                    order[faceBegin + i] = keys[i].face;
+                }
+            }
+        }
+
+        void BuildUVOrder(const std::vector<std::uint32_t>& indices, const std::vector<DirectX::XMFLOAT2>& uvs,
+                          std::size_t faceBegin, std::size_t faceEnd, std::vector<std::uint32_t>& order, TBB_ThreadPool* tp)
+        {
+            const std::size_t uvCount = uvs.size();
+            BuildFaceOrder(faceBegin, faceEnd, order, tp, [&](std::size_t f) {
+                const std::uint32_t i0 = indices[f * 3 + 0];
+                const std::uint32_t i1 = indices[f * 3 + 1];
+                const std::uint32_t i2 = indices[f * 3 + 2];
+                if (i0 >= uvCount || i1 >= uvCount || i2 >= uvCount)
+                    return 0u;
+                return MortonCode((uvs[i0].x + uvs[i1].x + uvs[i2].x) / 3.0f, (uvs[i0].y + uvs[i1].y + uvs[i2].y) / 3.0f);
+            });
+        }
+
+        void BuildVertexOrder(const std::vector<std::uint32_t>& indices, std::size_t vertexCount,
+                              std::size_t faceBegin, std::size_t faceEnd, std::vector<std::uint32_t>& order, TBB_ThreadPool* tp)
+        {
+            BuildFaceOrder(faceBegin, faceEnd, order, tp, [&](std::size_t f) {
+                const std::uint32_t i0 = indices[f * 3 + 0];
+                const std::uint32_t i1 = indices[f * 3 + 1];
+                const std::uint32_t i2 = indices[f * 3 + 2];
+                if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount)
+                    return 0u;
+                return std::min({i0, i1, i2});
+            });
+        }
+
+        DirectX::XMVECTOR NlerpVector(DirectX::FXMVECTOR a, DirectX::FXMVECTOR b, DirectX::FXMVECTOR c, const DirectX::XMFLOAT3& bary)
+        {
+            return DirectX::XMVector3NormalizeEst(
+                DirectX::XMVectorMultiplyAdd(c, DirectX::XMVectorReplicate(bary.z),
+                    DirectX::XMVectorMultiplyAdd(b, DirectX::XMVectorReplicate(bary.y),
+                        DirectX::XMVectorScale(a, bary.x)))
+            );
+        }
+
+        DirectX::XMVECTOR SlerpVector(DirectX::FXMVECTOR a, DirectX::FXMVECTOR b, float t)
+        {
+            const float dotAB = std::clamp(DirectX::XMVectorGetX(DirectX::XMVector3Dot(a, b)), -1.0f, 1.0f);
+            const float theta = acosf(dotAB) * t;
+            const DirectX::XMVECTOR relVec = DirectX::XMVector3NormalizeEst(
+                DirectX::XMVectorSubtract(b, DirectX::XMVectorScale(a, dotAB))
+            );
+            return DirectX::XMVector3NormalizeEst(
+                DirectX::XMVectorAdd(
+                    DirectX::XMVectorScale(a, cosf(theta)),
+                    DirectX::XMVectorScale(relVec, sinf(theta))
+                )
+            );
+        }
+
+        void LaplacianSmooth(const AdjacencyList& ring, const std::vector<DirectX::XMFLOAT3>& src, float weight,
+                             std::size_t begin, std::size_t end, std::vector<DirectX::XMFLOAT3>& dst)
+        {
+            for (std::size_t i = begin; i < end; i++)
+            {
+                const auto neighbors = ring[i];
+                const auto& original = src[i];
+                if (neighbors.empty())
+                {
+                    dst[i] = original;
+                    continue;
+                }
+                float x = 0.0f, y = 0.0f, z = 0.0f;
+                for (const auto& ni : neighbors)
+                {
+                    x += src[ni].x;
+                    y += src[ni].y;
+                    z += src[ni].z;
+                }
+                const float inv = 1.0f / neighbors.size();
+                dst[i] = {
+                    original.x + (x * inv - original.x) * weight,
+                    original.y + (y * inv - original.y) * weight,
+                    original.z + (z * inv - original.z) * weight};
+            }
+        }
+
+        void Float3Planes::Resize(std::size_t n)
+        {
+            const std::size_t padded = PaddedSize(n);
+            x.resize(padded);
+            y.resize(padded);
+            z.resize(padded);
+            std::fill(x.begin() + n, x.end(), 0.0f);
+            std::fill(y.begin() + n, y.end(), 0.0f);
+            std::fill(z.begin() + n, z.end(), 0.0f);
+            count = n;
+        }
+        void Float3Planes::Clear()
+        {
+            x.clear();
+            y.clear();
+            z.clear();
+            count = 0;
+        }
+        void Float3Planes::Load(const std::vector<DirectX::XMFLOAT3>& src, TBB_ThreadPool* tp)
+        {
+            Resize(src.size());
+            tp->Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, src.size()),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                        for (std::size_t i = r.begin(); i != r.end(); ++i)
+                        {
+                            x[i] = src[i].x;
+                            y[i] = src[i].y;
+                            z[i] = src[i].z;
+                        }
+                    },
+                    tbb::auto_partitioner()
+                );
+            });
+        }
+        void Float3Planes::Store(std::vector<DirectX::XMFLOAT3>& dst, TBB_ThreadPool* tp) const
+        {
+            dst.resize(count);
+            tp->Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, count),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                        for (std::size_t i = r.begin(); i != r.end(); ++i)
+                        {
+                            dst[i] = {x[i], y[i], z[i]};
+                        }
+                    },
+                    tbb::auto_partitioner()
+                );
+            });
+        }
+
+        void Float2Planes::Resize(std::size_t n)
+        {
+            const std::size_t padded = PaddedSize(n);
+            x.resize(padded);
+            y.resize(padded);
+            std::fill(x.begin() + n, x.end(), 0.0f);
+            std::fill(y.begin() + n, y.end(), 0.0f);
+            count = n;
+        }
+        void Float2Planes::Clear()
+        {
+            x.clear();
+            y.clear();
+            count = 0;
+        }
+        void Float2Planes::Load(const std::vector<DirectX::XMFLOAT2>& src, TBB_ThreadPool* tp)
+        {
+            Resize(src.size());
+            tp->Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, src.size()),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                        for (std::size_t i = r.begin(); i != r.end(); ++i)
+                        {
+                            x[i] = src[i].x;
+                            y[i] = src[i].y;
+                        }
+                    },
+                    tbb::auto_partitioner()
+                );
+            });
+        }
+
+        void FacePlanes::Resize(std::size_t n)
+        {
+            const std::size_t padded = PaddedSize(n);
+            i0.resize(padded);
+            i1.resize(padded);
+            i2.resize(padded);
+            std::fill(i0.begin() + n, i0.end(), 0);
+            std::fill(i1.begin() + n, i1.end(), 0);
+            std::fill(i2.begin() + n, i2.end(), 0);
+            count = n;
+        }
+        void FacePlanes::Clear()
+        {
+            i0.clear();
+            i1.clear();
+            i2.clear();
+            count = 0;
+        }
+        void FacePlanes::Load(const std::vector<std::uint32_t>& indices, std::size_t vertexCount, TBB_ThreadPool* tp)
+        {
+            const std::size_t triCount = indices.size() / 3;
+            Resize(triCount);
+            tp->Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, triCount),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                        for (std::size_t i = r.begin(); i != r.end(); ++i)
+                        {
+                            const std::size_t offset = i * 3;
+                            const std::uint32_t v0 = indices[offset + 0];
+                            const std::uint32_t v1 = indices[offset + 1];
+                            const std::uint32_t v2 = indices[offset + 2];
+                            const bool isValid = v0 < vertexCount && v1 < vertexCount && v2 < vertexCount;
+                            i0[i] = isValid ? v0 : 0;
+                            i1[i] = isValid ? v1 : 0;
+                            i2[i] = isValid ? v2 : 0;
+                        }
+                    },
+                    tbb::auto_partitioner()
+                );
+            });
+        }
+
+        namespace {
+            struct LaneAVX2 {
+                using F = __m256;
+                using I = __m256i;
+                static constexpr std::size_t width = 8;
+
+                static inline F Load(const float* p) { return _mm256_load_ps(p); }
+                static inline void Store(float* p, F v) { _mm256_store_ps(p, v); }
+                static inline I LoadIndex(const std::uint32_t* p) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(p)); }
+                static inline F LoadMask(const std::uint32_t* p) { return _mm256_castsi256_ps(LoadIndex(p)); }
+                static inline F Gather(const float* base, I idx) { return _mm256_i32gather_ps(base, idx, 4); }
+                static inline F Set1(float f) { return _mm256_set1_ps(f); }
+                static inline F Zero() { return _mm256_setzero_ps(); }
+                static inline F Add(F a, F b) { return _mm256_add_ps(a, b); }
+                static inline F Sub(F a, F b) { return _mm256_sub_ps(a, b); }
+                static inline F Mul(F a, F b) { return _mm256_mul_ps(a, b); }
+                static inline F Div(F a, F b) { return _mm256_div_ps(a, b); }
+                static inline F RSqrt(F a) { return _mm256_rsqrt_ps(a); }
+                static inline F Sqrt(F a) { return _mm256_sqrt_ps(a); }
+                static inline F Abs(F a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+                static inline F And(F a, F b) { return _mm256_and_ps(a, b); }
+                static inline F AndNot(F a, F b) { return _mm256_andnot_ps(a, b); }
+                static inline F Or(F a, F b) { return _mm256_or_ps(a, b); }
+                static inline F CmpLT(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+                static inline F CmpGT(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+                static inline F Select(F a, F b, F mask) { return _mm256_blendv_ps(a, b, mask); } // mask ? b : a
+                static inline int MoveMask(F a) { return _mm256_movemask_ps(a); }
+                static inline F Ramp() { return _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f); }
+            };
+
+            struct LaneSSE {
+                using F = __m128;
+                using I = const std::uint32_t*;
+                static constexpr std::size_t width = 4;
+
+                static inline F Load(const float* p) { return _mm_load_ps(p); }
+                static inline void Store(float* p, F v) { _mm_store_ps(p, v); }
+                static inline I LoadIndex(const std::uint32_t* p) { return p; }
+                static inline F LoadMask(const std::uint32_t* p) { return _mm_castsi128_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(p))); }
+                static inline F Gather(const float* base, I idx) { return _mm_set_ps(base[idx[3]], base[idx[2]], base[idx[1]], base[idx[0]]); }
+                static inline F Set1(float f) { return _mm_set1_ps(f); }
+                static inline F Zero() { return _mm_setzero_ps(); }
+                static inline F Add(F a, F b) { return _mm_add_ps(a, b); }
+                static inline F Sub(F a, F b) { return _mm_sub_ps(a, b); }
+                static inline F Mul(F a, F b) { return _mm_mul_ps(a, b); }
+                static inline F Div(F a, F b) { return _mm_div_ps(a, b); }
+                static inline F RSqrt(F a) { return _mm_rsqrt_ps(a); }
+                static inline F Sqrt(F a) { return _mm_sqrt_ps(a); }
+                static inline F Abs(F a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+                static inline F And(F a, F b) { return _mm_and_ps(a, b); }
+                static inline F AndNot(F a, F b) { return _mm_andnot_ps(a, b); }
+                static inline F Or(F a, F b) { return _mm_or_ps(a, b); }
+                static inline F CmpLT(F a, F b) { return _mm_cmplt_ps(a, b); }
+                static inline F CmpGT(F a, F b) { return _mm_cmpgt_ps(a, b); }
+                static inline F Select(F a, F b, F mask) { return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a)); } // mask ? b : a
+                static inline int MoveMask(F a) { return _mm_movemask_ps(a); }
+                static inline F Ramp() { return _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f); }
+            };
+
+            template <typename L>
+            void ComputeFaceDataImpl(const Float3Planes& positions, const Float2Planes& uvs, const FacePlanes& faces,
+                                     std::size_t blockBegin, std::size_t blockEnd,
+                                     Float3Planes& faceNormals, Float3Planes& faceTangents, Float3Planes& faceBitangents)
+            {
+                using F = typename L::F;
+                const F zero = L::Zero();
+                const F one = L::Set1(1.0f);
+                const F precision = L::Set1(floatPrecision);
+                const float* px = positions.x.data();
+                const float* py = positions.y.data();
+                const float* pz = positions.z.data();
+                const float* ux = uvs.x.data();
+                const float* uy = uvs.y.data();
+
+                const std::size_t end = std::min(blockEnd * laneWidth, faces.i0.size());
+                for (std::size_t i = blockBegin * laneWidth; i < end; i += L::width)
+                {
+                    const auto i0 = L::LoadIndex(&faces.i0[i]);
+                    const auto i1 = L::LoadIndex(&faces.i1[i]);
+                    const auto i2 = L::LoadIndex(&faces.i2[i]);
+
+                    const F p0x = L::Gather(px, i0), p0y = L::Gather(py, i0), p0z = L::Gather(pz, i0);
+                    const F dp1x = L::Sub(L::Gather(px, i1), p0x);
+                    const F dp1y = L::Sub(L::Gather(py, i1), p0y);
+                    const F dp1z = L::Sub(L::Gather(pz, i1), p0z);
+                    const F dp2x = L::Sub(L::Gather(px, i2), p0x);
+                    const F dp2y = L::Sub(L::Gather(py, i2), p0y);
+                    const F dp2z = L::Sub(L::Gather(pz, i2), p0z);
+
+                    // Normal
+                    const F nx = L::Sub(L::Mul(dp1y, dp2z), L::Mul(dp1z, dp2y));
+                    const F ny = L::Sub(L::Mul(dp1z, dp2x), L::Mul(dp1x, dp2z));
+                    const F nz = L::Sub(L::Mul(dp1x, dp2y), L::Mul(dp1y, dp2x));
+                    const F lenSq = L::Add(L::Add(L::Mul(nx, nx), L::Mul(ny, ny)), L::Mul(nz, nz));
+                    const F invLen = L::And(L::CmpGT(lenSq, zero), L::RSqrt(lenSq)); // zero area face -> zero normal
+                    L::Store(&faceNormals.x[i], L::Mul(nx, invLen));
+                    L::Store(&faceNormals.y[i], L::Mul(ny, invLen));
+                    L::Store(&faceNormals.z[i], L::Mul(nz, invLen));
+
+                    // Tangent / Bitangent
+                    const F u0x = L::Gather(ux, i0), u0y = L::Gather(uy, i0);
+                    const F duv1x = L::Sub(L::Gather(ux, i1), u0x);
+                    const F duv1y = L::Sub(L::Gather(uy, i1), u0y);
+                    const F duv2x = L::Sub(L::Gather(ux, i2), u0x);
+                    const F duv2y = L::Sub(L::Gather(uy, i2), u0y);
+
+                    F r = L::Sub(L::Mul(duv1x, duv2y), L::Mul(duv2x, duv1y));
+                    r = L::Select(L::Div(one, r), one, L::CmpLT(L::Abs(r), precision));
+
+                    L::Store(&faceTangents.x[i], L::Mul(L::Sub(L::Mul(dp1x, duv2y), L::Mul(dp2x, duv1y)), r));
+                    L::Store(&faceTangents.y[i], L::Mul(L::Sub(L::Mul(dp1y, duv2y), L::Mul(dp2y, duv1y)), r));
+                    L::Store(&faceTangents.z[i], L::Mul(L::Sub(L::Mul(dp1z, duv2y), L::Mul(dp2z, duv1y)), r));
+
+                    L::Store(&faceBitangents.x[i], L::Mul(L::Sub(L::Mul(dp2x, duv1x), L::Mul(dp1x, duv2x)), r));
+                    L::Store(&faceBitangents.y[i], L::Mul(L::Sub(L::Mul(dp2y, duv1x), L::Mul(dp1y, duv2x)), r));
+                    L::Store(&faceBitangents.z[i], L::Mul(L::Sub(L::Mul(dp2z, duv1x), L::Mul(dp1z, duv2x)), r));
+                }
+            }
+
+            template <typename L>
+            void FinalizeVertexBasisImpl(const Float3Planes& nSum, const Float3Planes& tSum, const Float3Planes& bSum, const AlignedVector<std::uint32_t>& valid,
+                                         std::size_t blockBegin, std::size_t blockEnd,
+                                         Float3Planes& normals, Float3Planes& tangents, Float3Planes& bitangents)
+            {
+                using F = typename L::F;
+                const F zero = L::Zero();
+                const F precision = L::Set1(floatPrecision);
+
+                auto dot = [](F ax, F ay, F az, F bx, F by, F bz) {
+                    return L::Add(L::Add(L::Mul(ax, bx), L::Mul(ay, by)), L::Mul(az, bz));
+                };
+
+                const std::size_t end = std::min(blockEnd * laneWidth, valid.size());
+                for (std::size_t i = blockBegin * laneWidth; i < end; i += L::width)
+                {
+                    F nx = L::Load(&nSum.x[i]), ny = L::Load(&nSum.y[i]), nz = L::Load(&nSum.z[i]);
+                    F tx = L::Load(&tSum.x[i]), ty = L::Load(&tSum.y[i]), tz = L::Load(&tSum.z[i]);
+                    F bx = L::Load(&bSum.x[i]), by = L::Load(&bSum.y[i]), bz = L::Load(&bSum.z[i]);
+
+                    const F nLenSq = dot(nx, ny, nz, nx, ny, nz);
+                    const F nValid = L::And(L::LoadMask(&valid[i]), L::CmpGT(nLenSq, zero));
+                    const F nInv = L::RSqrt(nLenSq);
+                    nx = L::Mul(nx, nInv);
+                    ny = L::Mul(ny, nInv);
+                    nz = L::Mul(nz, nInv);
+
+                    const F tLenSq = dot(tx, ty, tz, tx, ty, tz);
+                    const F tValid = L::CmpGT(L::Sqrt(tLenSq), precision);
+                    const F tInv = L::And(tValid, L::RSqrt(tLenSq));
+                    tx = L::Mul(tx, tInv);
+                    ty = L::Mul(ty, tInv);
+                    tz = L::Mul(tz, tInv);
+
+                    const F bLenSq = dot(bx, by, bz, bx, by, bz);
+                    const F bValid = L::CmpGT(L::Sqrt(bLenSq), precision);
+                    const F bInv = L::And(bValid, L::RSqrt(bLenSq));
+                    bx = L::Mul(bx, bInv);
+                    by = L::Mul(by, bInv);
+                    bz = L::Mul(bz, bInv);
+
+                    // Gram-Schmidt
+                    const F nt = dot(nx, ny, nz, tx, ty, tz);
+                    F ox = L::Sub(tx, L::Mul(nx, nt));
+                    F oy = L::Sub(ty, L::Mul(ny, nt));
+                    F oz = L::Sub(tz, L::Mul(nz, nt));
+                    const F oLenSq = dot(ox, oy, oz, ox, oy, oz);
+                    const F oValid = L::And(tValid, L::CmpGT(oLenSq, zero));
+                    const F oInv = L::RSqrt(oLenSq);
+                    ox = L::Mul(ox, oInv);
+                    oy = L::Mul(oy, oInv);
+                    oz = L::Mul(oz, oInv);
+
+                    F cx = L::Sub(L::Mul(ny, oz), L::Mul(nz, oy));
+                    F cy = L::Sub(L::Mul(nz, ox), L::Mul(nx, oz));
+                    F cz = L::Sub(L::Mul(nx, oy), L::Mul(ny, ox));
+                    const F cLenSq = dot(cx, cy, cz, cx, cy, cz);
+                    const F cValid = L::And(oValid, L::CmpGT(cLenSq, zero));
+                    const F cInv = L::RSqrt(cLenSq);
+                    cx = L::Mul(cx, cInv);
+                    cy = L::Mul(cy, cInv);
+                    cz = L::Mul(cz, cInv);
+
+                    // without a usable tangent the bitangent falls back to its own normalized sum
+                    bx = L::Select(bx, cx, tValid);
+                    by = L::Select(by, cy, tValid);
+                    bz = L::Select(bz, cz, tValid);
+                    const F writeT = L::And(nValid, oValid);
+                    const F writeB = L::And(nValid, L::Select(bValid, cValid, tValid));
+
+                    L::Store(&normals.x[i], L::Select(L::Load(&normals.x[i]), nx, nValid));
+                    L::Store(&normals.y[i], L::Select(L::Load(&normals.y[i]), ny, nValid));
+                    L::Store(&normals.z[i], L::Select(L::Load(&normals.z[i]), nz, nValid));
+                    L::Store(&tangents.x[i], L::Select(L::Load(&tangents.x[i]), ox, writeT));
+                    L::Store(&tangents.y[i], L::Select(L::Load(&tangents.y[i]), oy, writeT));
+                    L::Store(&tangents.z[i], L::Select(L::Load(&tangents.z[i]), oz, writeT));
+                    L::Store(&bitangents.x[i], L::Select(L::Load(&bitangents.x[i]), bx, writeB));
+                    L::Store(&bitangents.y[i], L::Select(L::Load(&bitangents.y[i]), by, writeB));
+                    L::Store(&bitangents.z[i], L::Select(L::Load(&bitangents.z[i]), bz, writeB));
+                }
+            }
+
+            // e(x, y) = e0 + dx * x + dy * y at the pixel center, >= 0 inside
+            struct EdgeFunction {
+                std::int64_t e0x2, dx, dy; // e0 is doubled, so the pixel center offsets stay integers
+
+                EdgeFunction(const DirectX::XMINT2& from, const DirectX::XMINT2& to, std::int64_t sign) {
+                    dx = sign * -(static_cast<std::int64_t>(to.y) - from.y);
+                    dy = sign * (static_cast<std::int64_t>(to.x) - from.x);
+                    e0x2 = -dx * (2 * static_cast<std::int64_t>(from.x) - 1) - dy * (2 * static_cast<std::int64_t>(from.y) - 1);
+                }
+                // exact at the block origin, so the float steps inside a block never drift
+                inline float At(std::int32_t x, std::int32_t y) const {
+                    return static_cast<float>(e0x2 + 2 * (dx * x + dy * y)) * 0.5f;
+                }
+                inline bool IsOutside(std::int32_t x0, std::int32_t y0, std::int32_t x1, std::int32_t y1) const {
+                    return std::max(dx * x0, dx * x1) + std::max(dy * y0, dy * y1) < -e0x2 / 2.0;
+                }
+                inline bool IsInside(std::int32_t x0, std::int32_t y0, std::int32_t x1, std::int32_t y1) const {
+                    return std::min(dx * x0, dx * x1) + std::min(dy * y0, dy * y1) >= -e0x2 / 2.0;
+                }
+            };
+
+            template <typename L>
+            void RasterizeTriangleImpl(const DirectX::XMINT2& a, const DirectX::XMINT2& b, const DirectX::XMINT2& c,
+                                       std::int32_t minX, std::int32_t minY, std::int32_t maxX, std::int32_t maxY,
+                                       std::vector<RasterSpan>& spans)
+            {
+                using F = typename L::F;
+                constexpr std::int32_t blockSize = static_cast<std::int32_t>(laneWidth);
+
+                spans.clear();
+                const std::int64_t area = (static_cast<std::int64_t>(b.x) - a.x) * (static_cast<std::int64_t>(c.y) - a.y)
+                    - (static_cast<std::int64_t>(b.y) - a.y) * (static_cast<std::int64_t>(c.x) - a.x);
+                if (area == 0 || minX >= maxX || minY >= maxY)
+                    return;
+                const std::int64_t sign = area < 0 ? -1 : 1;
+
+                // the weight of a vertex is its opposite edge over the area
+                const EdgeFunction edges[3] = {EdgeFunction(b, c, sign), EdgeFunction(c, a, sign), EdgeFunction(a, b, sign)};
+                const F invArea = L::Set1(1.0f / static_cast<float>(area * sign));
+                const F zero = L::Zero();
+                const F ramp = L::Ramp();
+                F stepX[3];
+                for (std::uint32_t e = 0; e < 3; e++)
+                {
+                    stepX[e] = L::Mul(ramp, L::Set1(static_cast<float>(edges[e].dx)));
+                }
+
+                for (std::int32_t by = minY & ~(blockSize - 1); by < maxY; by += blockSize)
+                {
+                    const std::int32_t y0 = std::max(by, minY);
+                    const std::int32_t y1 = std::min(by + blockSize, maxY) - 1;
+                    for (std::int32_t bx = minX & ~(blockSize - 1); bx < maxX; bx += blockSize)
+                    {
+                        const std::int32_t x0 = std::max(bx, minX);
+                        const std::int32_t x1 = std::min(bx + blockSize, maxX) - 1;
+
+                        // the edge functions are linear, so the corners of the clipped block bound every pixel in it
+                        bool isRejected = false;
+                        bool isAccepted = true;
+                        for (std::uint32_t e = 0; e < 3; e++)
+                        {
+                            isRejected |= edges[e].IsOutside(x0, y0, x1, y1);
+                            isAccepted &= edges[e].IsInside(x0, y0, x1, y1);
+                        }
+                        if (isRejected)
+                            continue;
+
+                        const std::uint32_t clipMask = ((1u << (x1 - bx + 1)) - 1) & ~((1u << (x0 - bx)) - 1);
+                        float origin[3];
+                        for (std::uint32_t e = 0; e < 3; e++)
+                        {
+                            origin[e] = edges[e].At(bx, y0);
+                        }
+                        for (std::int32_t y = y0; y <= y1; y++)
+                        {
+                            RasterSpan span;
+                            span.x = bx;
+                            span.y = y;
+                            span.mask = 0;
+                            for (std::int32_t lane = 0; lane < blockSize; lane += static_cast<std::int32_t>(L::width))
+                            {
+                                F ev[3];
+                                F outside = zero;
+                                for (std::uint32_t e = 0; e < 3; e++)
+                                {
+                                    const float rowOrigin = origin[e] + static_cast<float>(edges[e].dy * (y - y0) + edges[e].dx * lane);
+                                    ev[e] = L::Add(L::Set1(rowOrigin), stepX[e]);
+                                    outside = L::Or(outside, L::CmpLT(ev[e], zero));
+                                }
+                                if (!isAccepted)
+                                    span.mask |= static_cast<std::uint32_t>(~L::MoveMask(outside) & ((1 << L::width) - 1)) << lane;
+                                L::Store(&span.u[lane], L::Mul(ev[0], invArea));
+                                L::Store(&span.v[lane], L::Mul(ev[1], invArea));
+                                L::Store(&span.w[lane], L::Mul(ev[2], invArea));
+                            }
+                            span.mask = isAccepted ? clipMask : span.mask & clipMask;
+                            if (span.mask != 0)
+                                spans.push_back(span);
+                        }
+                    }
+                }
+            }
+        }
+
+        void ComputeFaceData(const Float3Planes& positions, const Float2Planes& uvs, const FacePlanes& faces,
+                             std::size_t blockBegin, std::size_t blockEnd,
+                             Float3Planes& faceNormals, Float3Planes& faceTangents, Float3Planes& faceBitangents)
+        {
+            if (GetSIMDType() == SIMDType::avx2)
+                ComputeFaceDataImpl<LaneAVX2>(positions, uvs, faces, blockBegin, blockEnd, faceNormals, faceTangents, faceBitangents);
+            else
+                ComputeFaceDataImpl<LaneSSE>(positions, uvs, faces, blockBegin, blockEnd, faceNormals, faceTangents, faceBitangents);
+        }
+
+        void FinalizeVertexBasis(const Float3Planes& nSum, const Float3Planes& tSum, const Float3Planes& bSum, const AlignedVector<std::uint32_t>& valid,
+                                 std::size_t blockBegin, std::size_t blockEnd,
+                                 Float3Planes& normals, Float3Planes& tangents, Float3Planes& bitangents)
+        {
+            if (GetSIMDType() == SIMDType::avx2)
+                FinalizeVertexBasisImpl<LaneAVX2>(nSum, tSum, bSum, valid, blockBegin, blockEnd, normals, tangents, bitangents);
+            else
+                FinalizeVertexBasisImpl<LaneSSE>(nSum, tSum, bSum, valid, blockBegin, blockEnd, normals, tangents, bitangents);
+        }
+
+        void RasterizeTriangle(const DirectX::XMINT2& a, const DirectX::XMINT2& b, const DirectX::XMINT2& c,
+                               std::int32_t minX, std::int32_t minY, std::int32_t maxX, std::int32_t maxY,
+                               std::vector<RasterSpan>& spans)
+        {
+            if (GetSIMDType() == SIMDType::avx2)
+                RasterizeTriangleImpl<LaneAVX2>(a, b, c, minX, minY, maxX, maxY, spans);
+            else
+                RasterizeTriangleImpl<LaneSSE>(a, b, c, minX, minY, maxX, maxY, spans);
+        }
+    }
+}
@@ -80,6 +80,66 @@ namespace Mus {
 		return a_resource ? true : false;
 	}
 
+	std::shared_future<void> NormalMapStore::AcquireOrWait(std::uint64_t a_key)
+	{
+		std::lock_guard lg(bakeLock);
+		auto [found, registered] = bakes.try_emplace(a_key);
+		if (registered)
+		{
+			found->second = std::make_unique<Bake>();
+			return {};
+		}
+		return found->second->future;
+	}
+	void NormalMapStore::EndBake(std::uint64_t a_key)
+	{
+		std::unique_ptr<Bake> bake;
+		{
+			std::lock_guard lg(bakeLock);
+			auto found = bakes.find(a_key);
+			if (found == bakes.end())
+				return;
+			bake = std::move(found->second);
+			bakes.erase(found);
+		}
+		bake->done.set_value();
+	}
+	bool NormalMapStore::BakeGuard::Acquire(std::uint64_t a_key)
+	{
+		bool waited = false;
+		while (true)
+		{
+			const auto future = NormalMapStore::GetSingleton().AcquireOrWait(a_key);
+			if (!future.valid())
+			{
+				keys.push_back(a_key);
+				return waited;
+			}
+			waited = true;
+			if (future.wait_for(bakeWaitTimeout) == std::future_status::timeout)
+			{
+				logger::warn("Timed out waiting for bake {:x}", a_key);
+				return waited;
+			}
+		}
+	}
+	void NormalMapStore::BakeGuard::End(std::uint64_t a_key)
+	{
+		auto found = std::find(keys.begin(), keys.end(), a_key);
+		if (found == keys.end())
+			return;
+		keys.erase(found);
+		NormalMapStore::GetSingleton().EndBake(a_key);
+	}
+	void NormalMapStore::BakeGuard::End()
+	{
+		for (const auto key : keys)
+		{
+			NormalMapStore::GetSingleton().EndBake(key);
+		}
+		keys.clear();
+	}
+
 	void NormalMapStore::AddHashPair(std::uint64_t a_hash, std::uint64_t b_hash)
 	{
         std::lock_guard lg(hashPairsLock);
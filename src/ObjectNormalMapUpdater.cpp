@@ -117,7 +117,7 @@ namespace Mus {
 		return true;
 	}
 
-	void ObjectNormalMapUpdater::LoadCacheResource(RE::FormID a_actorID, GeometryDataPtr a_data, UpdateSet& a_updateSet, MergedTextureGeometries& mergedTextureGeometries, ResourceDatas& resourceDatas, UpdateResult& results)
+	void ObjectNormalMapUpdater::LoadCacheResource(RE::FormID a_actorID, GeometryDataPtr a_data, UpdateSet& a_updateSet, MergedTextureGeometries& mergedTextureGeometries, ResourceDatas& resourceDatas, UpdateResult& results, NormalMapStore::BakeGuard& bakeGuard)
 	{
 		//hash update with geo hash + texture hash
         for (auto it = a_updateSet.begin(); it != a_updateSet.end();)
@@ -135,6 +135,24 @@ namespace Mus {
             it++;
 		}
 
+		//own the bakes of this update before the store lookup, another update with the same bake waits here and then finds its result in the store
+		//keys are taken in ascending order so that two updates never wait on each other
+		std::set<std::uint64_t> bakeKeys;
+		for (const auto& update : a_updateSet)
+		{
+			const auto found = std::find_if(a_data->geometries.begin(), a_data->geometries.end(), [&](GeometryData::GeometriesInfo& geosInfo) {
+				return geosInfo.geometry == update.first;
+			});
+			if (found == a_data->geometries.end())
+				continue;
+			bakeKeys.insert(GetBakeKey(found->hash));
+		}
+		for (const auto key : bakeKeys)
+		{
+			if (bakeGuard.Acquire(key))
+				logger::info("{}::{:x} : Waited for the same bake in another update ({:x})", __func__, a_actorID, key);
+		}
+
 		//find texture from cache
         std::sort(a_updateSet.begin(), a_updateSet.end(), [&](std::pair<RE::BSGeometry*, UpdateTextureSet>& a, std::pair<RE::BSGeometry*, UpdateTextureSet>& b) {
 			const auto aIt = std::find_if(a_data->geometries.begin(), a_data->geometries.end(), [&](GeometryData::GeometriesInfo& geosInfo) {
@@ -316,9 +334,26 @@ namespace Mus {
 			mergedTextureGeometries.insert(it->first);
             it = a_updateSet.erase(it);
 		}
+
+		//everything left is baked by this update, the others are resolved already
+		std::unordered_set<std::uint64_t> leftKeys;
+		for (const auto& update : a_updateSet)
+		{
+			const auto found = std::find_if(a_data->geometries.begin(), a_data->geometries.end(), [&](GeometryData::GeometriesInfo& geosInfo) {
+				return geosInfo.geometry == update.first;
+			});
+			if (found == a_data->geometries.end())
+				continue;
+			leftKeys.insert(GetBakeKey(found->hash));
+		}
+		for (const auto key : bakeKeys)
+		{
+			if (!leftKeys.contains(key))
+				bakeGuard.End(key);
+		}
 	}
 
-	bool ObjectNormalMapUpdater::CreateGeometryResourceData(RE::FormID a_actorID, GeometryDataPtr a_data)
+	bool ObjectNormalMapUpdater::CreateGeometryResourceData(RE::FormID a_actorID, GeometryDataPtr a_data, const UpdateSet& a_updateSet)
 	{
 		a_data->GetGeometryData();
 
@@ -329,6 +364,24 @@ namespace Mus {
 			logger::error("{} : Invalid parameters", __func__);
 			return false;
         }
+        // the adaptive subdivision counts texels at the size the bake writes, the dst grows to a bigger detail texture
+        for (const auto& update : a_updateSet)
+        {
+            auto found = std::find_if(a_data->geometries.begin(), a_data->geometries.end(), [&](const GeometryData::GeometriesInfo& geosInfo) {
+                return geosInfo.geometry == update.first;
+            });
+            if (found == a_data->geometries.end())
+                continue;
+            found->bakeWidth = Config::GetSingleton().GetTextureWidth();
+            found->bakeHeight = Config::GetSingleton().GetTextureHeight();
+            UINT detailWidth = 0, detailHeight = 0;
+            if (!update.second.detailTexturePath.empty()
+                && Shader::TextureLoadManager::GetSingleton().GetTextureSize(update.second.detailTexturePath, detailWidth, detailHeight))
+            {
+                found->bakeWidth = std::max(found->bakeWidth, detailWidth);
+                found->bakeHeight = std::max(found->bakeHeight, detailHeight);
+            }
+        }
         a_data->GeometryProcessing();
 
 		if (a_data->vertices.size() != a_data->uvs.size() ||
@@ -359,7 +412,19 @@ namespace Mus {
 				return false;
 			if (!CreateStructuredBuffer(device, a_data->bitangents.data(), UINT(sizeof(DirectX::XMFLOAT3) * a_data->bitangents.size()), sizeof(DirectX::XMFLOAT3), newGeometryResourceData->bitangentBuffer, newGeometryResourceData->bitangentSRV))
 				return false;
-			if (!CreateStructuredBuffer(device, a_data->indices.data(), UINT(sizeof(std::uint32_t) * a_data->indices.size()), sizeof(std::uint32_t), newGeometryResourceData->indicesBuffer, newGeometryResourceData->indicesSRV))
+			// the shader bakes the faces in buffer order, so they go in the bake order
+			// a face never leaves the range of its geometry, so indicesStart and indicesEnd stay valid
+			std::vector<std::uint32_t> bakeIndices;
+			if (!a_data->bakeOrder.empty())
+			{
+				bakeIndices.resize(a_data->indices.size());
+				for (std::size_t i = 0; i < a_data->bakeOrder.size(); i++)
+				{
+					std::memcpy(&bakeIndices[i * 3], &a_data->indices[a_data->bakeOrder[i] * 3], sizeof(std::uint32_t) * 3);
+				}
+			}
+			const std::vector<std::uint32_t>& gpuIndices = bakeIndices.empty() ? a_data->indices : bakeIndices;
+			if (!CreateStructuredBuffer(device, gpuIndices.data(), UINT(sizeof(std::uint32_t) * gpuIndices.size()), sizeof(std::uint32_t), newGeometryResourceData->indicesBuffer, newGeometryResourceData->indicesSRV))
 				return false;
 
 			{
@@ -382,6 +447,11 @@ namespace Mus {
         std::lock_guard lg(geometryResourceDataMapLock);
         geometryResourceDataMap.clear();
 	}
+	void ObjectNormalMapUpdater::RemoveGeometryResourceData(RE::FormID a_actorID)
+	{
+        std::lock_guard lg(geometryResourceDataMapLock);
+        geometryResourceDataMap.erase(a_actorID);
+	}
 
 	ObjectNormalMapUpdater::GeometryResourceDataPtr ObjectNormalMapUpdater::GetGeometryResourceData(RE::FormID a_actorID)
 	{
@@ -402,6 +472,22 @@ namespace Mus {
 										+ std::to_string(geoHash));
 	}
 
+	std::uint64_t ObjectNormalMapUpdater::GetBakeKey(std::uint64_t a_hash) const
+	{
+		const std::int64_t key[] = {static_cast<std::int64_t>(a_hash),
+									Config::GetSingleton().GetTextureWidth(),
+									Config::GetSingleton().GetTextureHeight(),
+									Config::GetSingleton().GetTangentZCorrection(),
+									Config::GetSingleton().GetUseMipMap(),
+									Config::GetSingleton().GetTextureCompress(),
+									Config::GetSingleton().GetTextureCompressQuality(),
+									Config::GetSingleton().GetIgnoreMissingNormalMap(),
+									Config::GetSingleton().GetNormalInterpolation(),
+									Config::GetSingleton().GetOrthogonalizeTangent(),
+									Config::GetSingleton().GetGPUEnable()};
+		return XXH3_64bits(key, sizeof(key));
+	}
+
 	ObjectNormalMapUpdater::UpdateResult ObjectNormalMapUpdater::UpdateObjectNormalMap(RE::FormID a_actorID, GeometryDataPtr a_data, UpdateSet& a_updateSet)
     {
         RefGuard rg(this);
@@ -424,9 +510,12 @@ namespace Mus {
 
 		MergedTextureGeometries mergedTextureGeometries;
         ResourceDatas resourceDatas;
-		LoadCacheResource(a_actorID, a_data, a_updateSet, mergedTextureGeometries, resourceDatas, results);
+		NormalMapStore::BakeGuard bakeGuard;
+		LoadCacheResource(a_actorID, a_data, a_updateSet, mergedTextureGeometries, resourceDatas, results, bakeGuard);
 
         const bool tangentZCorrection = Config::GetSingleton().GetTangentZCorrection();
+        const bool nlerp = Config::GetSingleton().GetNormalInterpolation() == Config::NormalInterpolationList::Nlerp;
+        const bool orthogonalizeTangent = Config::GetSingleton().GetOrthogonalizeTangent();
 
         for (const auto& update : a_updateSet)
         {
@@ -447,35 +536,38 @@ namespace Mus {
             TextureResourceDataPtr newResourceData = std::make_shared<TextureResourceData>();
             newResourceData->geometry = update.first;
             newResourceData->textureName = update.second.textureName;
+            newResourceData->arena = a_data->arena;
 
-            D3D11_TEXTURE2D_DESC srcStagingDesc = {}, detailStagingDesc = {}, overlayStagingDesc = {}, maskStagingDesc = {}, dstDesc = {};
+            D3D11_TEXTURE2D_DESC dstDesc = {};
+            Shader::TextureCPUCache::ImagePtr srcImage, detailImage, overlayImage, maskImage;
 
+            // the dst grows to a bigger detail texture, so the detail goes first and every other texture is loaded at the mip matching the dst
+            UINT dstWidth = Config::GetSingleton().GetTextureWidth();
+            UINT dstHeight = Config::GetSingleton().GetTextureHeight();
+            if (!update.second.detailTexturePath.empty())
+            {
+                logger::info("{}::{:x}::{} : {} detail texture loading...)", _func_, a_actorID, update.second.geometryName, update.second.detailTexturePath);
+
+                if (LoadTextureCPU(device, context, update.second.detailTexturePath, 0, 0, detailImage))
+                {
+                    dstWidth = std::max(detailImage->width, dstWidth);
+                    dstHeight = std::max(detailImage->height, dstHeight);
+                }
+            }
             if (!update.second.srcTexturePath.empty())
             {
                 if (!IsDetailNormalMap(update.second.srcTexturePath))
                 {
                     logger::info("{}::{:x}::{} : {} src texture loading...)", _func_, a_actorID, update.second.geometryName, update.second.srcTexturePath);
-
-                    if (LoadTextureCPU(device, context, update.second.srcTexturePath, srcStagingDesc, newResourceData->srcTexture2D))
-                    {
-                        dstDesc = srcStagingDesc;
-                        dstDesc.Width = Config::GetSingleton().GetTextureWidth();
-                        dstDesc.Height = Config::GetSingleton().GetTextureHeight();
-                    }
+                    LoadTextureCPU(device, context, update.second.srcTexturePath, dstWidth, dstHeight, srcImage);
                 }
             }
-            if (!update.second.detailTexturePath.empty())
+            if (srcImage || detailImage)
             {
-                logger::info("{}::{:x}::{} : {} detail texture loading...)", _func_, a_actorID, update.second.geometryName, update.second.detailTexturePath);
-
-                if (LoadTextureCPU(device, context, update.second.detailTexturePath, detailStagingDesc, newResourceData->detailTexture2D))
-                {
-                    dstDesc = detailStagingDesc;
-                    dstDesc.Width = std::max(dstDesc.Width, Config::GetSingleton().GetTextureWidth());
-                    dstDesc.Height = std::max(dstDesc.Height, Config::GetSingleton().GetTextureHeight());
-                }
+                dstDesc.Width = dstWidth;
+                dstDesc.Height = dstHeight;
             }
-            if (!Config::GetSingleton().GetIgnoreMissingNormalMap() && !newResourceData->srcTexture2D && !newResourceData->detailTexture2D)
+            if (!Config::GetSingleton().GetIgnoreMissingNormalMap() && !srcImage && !detailImage)
             {
                 logger::error("{}::{:x}::{} : NormalMap is missing", _func_, a_actorID, update.second.geometryName);
                 continue;
@@ -484,13 +576,13 @@ namespace Mus {
             if (!update.second.overlayTexturePath.empty())
             {
                 logger::info("{}::{:x}::{} : {} overlay texture loading...)", _func_, a_actorID, update.second.geometryName, update.second.overlayTexturePath);
-                LoadTextureCPU(device, context, update.second.overlayTexturePath, overlayStagingDesc, newResourceData->overlayTexture2D);
+                LoadTextureCPU(device, context, update.second.overlayTexturePath, dstWidth, dstHeight, overlayImage);
             }
 
             if (!update.second.maskTexturePath.empty())
             {
                 logger::info("{}::{:x}::{} : {} mask texture loading...)", _func_, a_actorID, update.second.geometryName, update.second.maskTexturePath);
-                LoadTextureCPU(device, context, update.second.maskTexturePath, maskStagingDesc, newResourceData->maskTexture2D);
+                LoadTextureCPU(device, context, update.second.maskTexturePath, dstWidth, dstHeight, maskImage);
             }
 
             dstDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
@@ -525,57 +617,15 @@ namespace Mus {
                 logger::error("{}::{:x}::{} : Failed to map dst texture ({})", _func_, a_actorID, update.second.geometryName, dstmg.GetHR());
                 continue;
             }
-            Shader::MapGuard srcmg(context, newResourceData->srcTexture2D.Get(), 0, D3D11_MAP_READ);
-            if (newResourceData->srcTexture2D && !srcmg.IsValid())
-            {
-                logger::error("{}::{:x}::{} : Failed to map src texture ({})", _func_, a_actorID, update.second.geometryName, srcmg.GetHR());
-			}
-            Shader::MapGuard detailmg(context, newResourceData->detailTexture2D.Get(), 0, D3D11_MAP_READ);
-            if (newResourceData->detailTexture2D && !detailmg.IsValid())
-            {
-                logger::error("{}::{:x}::{} : Failed to map detail texture ({})", _func_, a_actorID, update.second.geometryName, detailmg.GetHR());
-            }
-            Shader::MapGuard overlaymg(context, newResourceData->overlayTexture2D.Get(), 0, D3D11_MAP_READ);
-            if (newResourceData->overlayTexture2D && !overlaymg.IsValid())
-            {
-                logger::error("{}::{:x}::{} : Failed to map overlay texture ({})", _func_, a_actorID, update.second.geometryName, overlaymg.GetHR());
-            }
-            Shader::MapGuard maskmg(context, newResourceData->maskTexture2D.Get(), 0, D3D11_MAP_READ);
-            if (newResourceData->maskTexture2D && !maskmg.IsValid())
-            {
-                logger::error("{}::{:x}::{} : Failed to map mask texture ({})", _func_, a_actorID, update.second.geometryName, maskmg.GetHR());
-            }
-
             std::uint8_t* dstData = dstmg.Get<std::uint8_t>();
-            std::uint8_t* srcData = srcmg.IsValid() ? srcmg.Get<std::uint8_t>() : nullptr;
-            std::uint8_t* detailData = detailmg.IsValid() ? detailmg.Get<std::uint8_t>() : nullptr; 
-            std::uint8_t* overlayData = overlaymg.IsValid() ? overlaymg.Get<std::uint8_t>() : nullptr;
-            std::uint8_t* maskData = maskmg.IsValid() ? maskmg.Get<std::uint8_t>() : nullptr;
+            const std::uint8_t* srcData = srcImage ? srcImage->pixels.data() : nullptr;
+            const std::uint8_t* detailData = detailImage ? detailImage->pixels.data() : nullptr;
+            const std::uint8_t* overlayData = overlayImage ? overlayImage->pixels.data() : nullptr;
+            const std::uint8_t* maskData = maskImage ? maskImage->pixels.data() : nullptr;
             
 			auto tp = currentProcessingThreads.load();
             const UINT width = dstDesc.Width;
             const UINT height = dstDesc.Height;
-            // init dst texture
-            {
-                tp->Execute([&] {
-                    tbb::parallel_for(
-                        tbb::blocked_range<UINT>(0, height),
-                        [&](const tbb::blocked_range<UINT>& r) {
-                            const std::int32_t ti = tbb::this_task_arena::current_thread_index();
-                            for (UINT y = r.begin(); y != r.end(); ++y)
-                            {
-                                std::uint8_t* rowData = dstData + y * dstmg.GetRowPitch();
-                                for (UINT x = 0; x < width; x++)
-                                {
-                                    std::uint32_t* pixel = reinterpret_cast<uint32_t*>(rowData + x * 4);
-                                    *pixel = emptyColor.GetReverse();
-                                }
-                            }
-                        },
-                        tbb::auto_partitioner()
-					);
-                });
-            }
 
             const bool hasSrcData = (srcData != nullptr);
             const bool hasDetailData = (detailData != nullptr);
@@ -586,33 +636,213 @@ namespace Mus {
                 PerformanceLog(std::string(_func_) + "::" + GetHexStr(a_actorID) + "::" + update.second.geometryName, true, false);
 
             const std::uint32_t totalTris = objInfo.indicesCount() / 3;
+            const std::uint32_t triStart = objInfo.indicesStart / 3;
             const std::uint32_t vertexEnd = a_data->vertices.size();
 
             const float WidthF = static_cast<const float>(width);
             const float HeightF = static_cast<const float>(height);
             const float invWidth = 1.0f / WidthF;
             const float invHeight = 1.0f / HeightF;
-            const float srcWidthF = hasSrcData ? static_cast<const float>(srcStagingDesc.Width) : 0.0f;
-            const float srcHeightF = hasSrcData ? static_cast<const float>(srcStagingDesc.Height) : 0.0f;
-            const float detailWidthF = hasDetailData ? static_cast<const float>(detailStagingDesc.Width) : 0.0f;
-            const float detailHeightF = hasDetailData ? static_cast<const float>(detailStagingDesc.Height) : 0.0f;
-            const float overlayWidthF = hasOverlayData ? static_cast<const float>(overlayStagingDesc.Width) : 0.0f;
-            const float overlayHeightF = hasOverlayData ? static_cast<const float>(overlayStagingDesc.Height) : 0.0f;
-            const float maskWidthF = hasMaskData ? static_cast<const float>(maskStagingDesc.Width) : 0.0f;
-            const float maskHeightF = hasMaskData ? static_cast<const float>(maskStagingDesc.Height) : 0.0f;
+            const float srcWidthF = hasSrcData ? static_cast<const float>(srcImage->width) : 0.0f;
+            const float srcHeightF = hasSrcData ? static_cast<const float>(srcImage->height) : 0.0f;
+            const float detailWidthF = hasDetailData ? static_cast<const float>(detailImage->width) : 0.0f;
+            const float detailHeightF = hasDetailData ? static_cast<const float>(detailImage->height) : 0.0f;
+            const float overlayWidthF = hasOverlayData ? static_cast<const float>(overlayImage->width) : 0.0f;
+            const float overlayHeightF = hasOverlayData ? static_cast<const float>(overlayImage->height) : 0.0f;
+            const float maskWidthF = hasMaskData ? static_cast<const float>(maskImage->width) : 0.0f;
+            const float maskHeightF = hasMaskData ? static_cast<const float>(maskImage->height) : 0.0f;
 
             const float detailStrength = update.second.detailStrength;
 
             if (Config::GetSingleton().GetUpdateNormalMapTime2())
                 PerformanceLog(std::string(_func_) + "::" + GetHexStr(a_actorID) + "::" + update.second.geometryName, false, false);
 
+            // triangles in pixel space, the bounding box max is exclusive and never reaches the last row and column
+            struct BakeTriangle {
+                std::uint32_t i0, i1, i2;
+                DirectX::XMINT2 p0, p1, p2;
+                std::int32_t minX, minY, maxX, maxY;
+            };
+            // one triangle clipped to [minX, maxX) x [minY, maxY), spans is the scratch of the calling thread
+            auto rasterize = [&](const BakeTriangle& tri, std::int32_t minX, std::int32_t minY, std::int32_t maxX, std::int32_t maxY,
+                                 std::vector<GeometryKernel::RasterSpan>& spans) {
+                const DirectX::XMINT2& p0 = tri.p0;
+                const DirectX::XMINT2& p1 = tri.p1;
+                const DirectX::XMINT2& p2 = tri.p2;
+
+                const DirectX::XMVECTOR n0v = DirectX::XMLoadFloat3(&a_data->normals[tri.i0]);
+                const DirectX::XMVECTOR n1v = DirectX::XMLoadFloat3(&a_data->normals[tri.i1]);
+                const DirectX::XMVECTOR n2v = DirectX::XMLoadFloat3(&a_data->normals[tri.i2]);
+
+                const DirectX::XMVECTOR t0v = DirectX::XMLoadFloat3(&a_data->tangents[tri.i0]);
+                const DirectX::XMVECTOR t1v = DirectX::XMLoadFloat3(&a_data->tangents[tri.i1]);
+                const DirectX::XMVECTOR t2v = DirectX::XMLoadFloat3(&a_data->tangents[tri.i2]);
+
+                const DirectX::XMVECTOR b0v = DirectX::XMLoadFloat3(&a_data->bitangents[tri.i0]);
+                const DirectX::XMVECTOR b1v = DirectX::XMLoadFloat3(&a_data->bitangents[tri.i1]);
+                const DirectX::XMVECTOR b2v = DirectX::XMLoadFloat3(&a_data->bitangents[tri.i2]);
+
+                GeometryKernel::RasterizeTriangle(p0, p1, p2, minX, minY, maxX, maxY, spans);
+                for (const auto& span : spans)
+                {
+                    const std::int32_t y = span.y;
+                    const float mY = static_cast<const float>(y) * invHeight;
+
+                    const std::uint8_t* srcRowData = nullptr;
+                    if (hasSrcData)
+                    {
+                        const float srcY = mY * srcHeightF;
+                        srcRowData = srcData + static_cast<const UINT>(srcY) * srcImage->rowPitch;
+                    }
+
+                    const std::uint8_t* detailRowData = nullptr;
+                    if (hasDetailData)
+                    {
+                        const float detailY = mY * detailHeightF;
+                        detailRowData = detailData + static_cast<const UINT>(detailY) * detailImage->rowPitch;
+                    }
+
+                    const std::uint8_t* overlayRowData = nullptr;
+                    if (hasOverlayData)
+                    {
+                        const float overlayY = mY * overlayHeightF;
+                        overlayRowData = overlayData + static_cast<const UINT>(overlayY) * overlayImage->rowPitch;
+                    }
+
+                    const std::uint8_t* maskRowData = nullptr;
+                    if (hasMaskData)
+                    {
+                        const float maskY = mY * maskHeightF;
+                        maskRowData = maskData + static_cast<const UINT>(maskY) * maskImage->rowPitch;
+                    }
+
+                    std::uint8_t* rowData = dstData + y * dstmg.GetRowPitch();
+                    for (std::uint32_t covered = span.mask; covered != 0; covered &= covered - 1)
+                    {
+                        const std::int32_t lane = std::countr_zero(covered);
+                        const std::int32_t x = span.x + lane;
+                        const DirectX::XMFLOAT3 bary = {span.u[lane], span.v[lane], span.w[lane]};
+
+                        const float mX = x * invWidth;
+
+                        RGBA dstColor;
+                        RGBA overlayColor(1.0f, 1.0f, 1.0f, 0.0f);
+                        if (hasOverlayData)
+                        {
+                            const float overlayX = mX * overlayWidthF;
+                            const std::uint32_t* overlayPixel = reinterpret_cast<const std::uint32_t*>(overlayRowData + static_cast<const UINT>(overlayX) * 4);
+                            overlayColor.SetReverse(*overlayPixel);
+                        }
+                        if (overlayColor.a < 1.0f)
+                        {
+                            RGBA maskColor(1.0f, 1.0f, 1.0f, 0.0f);
+                            if (hasMaskData && hasSrcData)
+                            {
+                                const float maskX = mX * maskWidthF;
+                                const std::uint32_t* maskPixel = reinterpret_cast<const std::uint32_t*>(maskRowData + static_cast<const UINT>(maskX) * 4);
+                                maskColor.SetReverse(*maskPixel);
+                            }
+                            if (maskColor.a < 1.0f)
+                            {
+                                RGBA detailColor(0.5f, 0.5f, 1.0f, 0.5f);
+                                if (hasDetailData)
+                                {
+                                    const float detailX = mX * detailWidthF;
+                                    const std::uint32_t* detailPixel = reinterpret_cast<const std::uint32_t*>(detailRowData + static_cast<const UINT>(detailX) * 4);
+                                    detailColor.SetReverse(*detailPixel);
+                                    detailColor = RGBA::lerp(RGBA(0.5f, 0.5f, 1.0f, detailColor.a), detailColor, detailStrength);
+                                }
+
+                                const float denomal = (bary.x + bary.y + floatPrecision);
+                                auto interpolate = [&](const DirectX::XMVECTOR& v0, const DirectX::XMVECTOR& v1, const DirectX::XMVECTOR& v2) {
+                                    if (nlerp)
+                                        return GeometryKernel::NlerpVector(v0, v1, v2, bary);
+                                    return GeometryKernel::SlerpVector(GeometryKernel::SlerpVector(v0, v1, bary.y / denomal), v2, bary.z);
+                                };
+                                const DirectX::XMVECTOR n = interpolate(n0v, n1v, n2v);
+
+                                DirectX::XMVECTOR normalResult = emptyVector;
+                                if (detailColor.a > 0.0f)
+                                {
+                                    const DirectX::XMVECTOR t = interpolate(t0v, t1v, t2v);
+
+                                    // the bitangent is rebuilt from n and t unless the interpolated one is used as is
+                                    DirectX::XMVECTOR ft, fb;
+                                    if (orthogonalizeTangent)
+                                    {
+                                        ft = DirectX::XMVector3NormalizeEst(
+                                            DirectX::XMVectorSubtract(t, DirectX::XMVectorScale(n, DirectX::XMVectorGetX(DirectX::XMVector3Dot(n, t)))));
+                                        fb = DirectX::XMVector3NormalizeEst(DirectX::XMVector3Cross(n, ft));
+                                    }
+                                    else
+                                    {
+                                        ft = t;
+                                        fb = interpolate(b0v, b1v, b2v);
+                                    }
+
+                                    const DirectX::XMMATRIX tbn = DirectX::XMMATRIX(ft, fb, n, DirectX::XMVectorSet(0, 0, 0, 1));
+
+                                    const DirectX::XMFLOAT4 detailColorF(
+                                        detailColor.r * 2.0f - 1.0f,
+                                        detailColor.g * 2.0f - 1.0f,
+                                        detailColor.b * 2.0f - 1.0f,
+                                        0.0f);
+                                    const DirectX::XMVECTOR detailNormalVec = DirectX::XMVectorSet(
+                                        detailColorF.x,
+                                        detailColorF.y,
+                                        tangentZCorrection ? std::sqrt(std::max(0.0f, 1.0f - detailColorF.x * detailColorF.x - detailColorF.y * detailColorF.y)) : detailColorF.z,
+                                        0.0f);
+
+                                    const DirectX::XMVECTOR detailNormal = DirectX::XMVector3NormalizeEst(
+                                        DirectX::XMVector3TransformNormal(detailNormalVec, tbn));
+                                    normalResult = DirectX::XMVector3NormalizeEst(
+                                        DirectX::XMVectorLerp(n, detailNormal, detailColor.a));
+                                }
+                                else
+                                {
+                                    normalResult = n;
+                                }
+                                const DirectX::XMVECTOR normalVec = DirectX::XMVectorMultiplyAdd(normalResult, halfVec, halfVec);
+                                dstColor = RGBA(DirectX::XMVectorGetX(normalVec), DirectX::XMVectorGetZ(normalVec), DirectX::XMVectorGetY(normalVec));
+                            }
+                            if (maskColor.a > 0.0f && hasSrcData)
+                            {
+                                const float srcX = mX * srcWidthF;
+                                const std::uint32_t* srcPixel = reinterpret_cast<const std::uint32_t*>(srcRowData + static_cast<const UINT>(srcX) * 4);
+                                RGBA srcColor;
+                                srcColor.SetReverse(*srcPixel);
+                                dstColor = RGBA::lerp(dstColor, srcColor, maskColor.a);
+                            }
+                        }
+                        if (overlayColor.a > 0.0f)
+                        {
+                            dstColor = RGBA::lerp(dstColor, overlayColor, overlayColor.a);
+                        }
+
+                        std::uint32_t* dstPixel = reinterpret_cast<std::uint32_t*>(rowData + x * 4);
+                        *dstPixel = dstColor.GetReverse() | 0xFF000000;
+                    }
+                }
+            };
+
+            // bin the triangles into tiles, then every tile is baked by one thread in the bake order
+            // so no pixel is written by two threads and overlapping triangles always end the same
+            constexpr std::int32_t tileSize = 64;
+            const std::uint32_t tilesX = (width + tileSize - 1) / tileSize;
+            const std::uint32_t tilesY = (height + tileSize - 1) / tileSize;
+            std::vector<BakeTriangle> bakeTris(totalTris);
+            std::vector<std::uint32_t> binOffsets(totalTris + 1, 0);
 			tp->Execute([&] {
                 tbb::parallel_for(
                     tbb::blocked_range<UINT>(0, totalTris),
                     [&](const tbb::blocked_range<UINT>& r) {
                         for (UINT i = r.begin(); i != r.end(); ++i)
                         {
-                            const std::uint32_t index = objInfo.indicesStart + i * 3;
+                            BakeTriangle& tri = bakeTris[i];
+                            tri = {};
+
+                            // neighbours in the bake order are neighbours in the uv space
+                            const std::uint32_t index = (a_data->bakeOrder.empty() ? triStart + i : a_data->bakeOrder[triStart + i]) * 3;
 
                             const std::uint32_t i0 = a_data->indices[index + 0];
                             const std::uint32_t i1 = a_data->indices[index + 1];
@@ -625,161 +855,85 @@ namespace Mus {
                             const DirectX::XMFLOAT2& u1 = a_data->uvs[i1];
                             const DirectX::XMFLOAT2& u2 = a_data->uvs[i2];
 
-                            const DirectX::XMVECTOR n0v = DirectX::XMLoadFloat3(&a_data->normals[i0]);
-                            const DirectX::XMVECTOR n1v = DirectX::XMLoadFloat3(&a_data->normals[i1]);
-                            const DirectX::XMVECTOR n2v = DirectX::XMLoadFloat3(&a_data->normals[i2]);
-
-                            const DirectX::XMVECTOR t0v = DirectX::XMLoadFloat3(&a_data->tangents[i0]);
-                            const DirectX::XMVECTOR t1v = DirectX::XMLoadFloat3(&a_data->tangents[i1]);
-                            const DirectX::XMVECTOR t2v = DirectX::XMLoadFloat3(&a_data->tangents[i2]);
-
-                            const DirectX::XMVECTOR b0v = DirectX::XMLoadFloat3(&a_data->bitangents[i0]);
-                            const DirectX::XMVECTOR b1v = DirectX::XMLoadFloat3(&a_data->bitangents[i1]);
-                            const DirectX::XMVECTOR b2v = DirectX::XMLoadFloat3(&a_data->bitangents[i2]);
-
                             // uvToPixel
                             const DirectX::XMINT2 p0 = {static_cast<int>(u0.x * width), static_cast<int>(u0.y * height)};
                             const DirectX::XMINT2 p1 = {static_cast<int>(u1.x * width), static_cast<int>(u1.y * height)};
                             const DirectX::XMINT2 p2 = {static_cast<int>(u2.x * width), static_cast<int>(u2.y * height)};
 
-                            const std::int32_t minX = std::max(0, std::min({p0.x, p1.x, p2.x}));
-                            const std::int32_t minY = std::max(0, std::min({p0.y, p1.y, p2.y}));
-                            const std::int32_t maxX = std::min((std::int32_t)width - 1, std::max({p0.x, p1.x, p2.x}) + 1);
-                            const std::int32_t maxY = std::min((std::int32_t)height - 1, std::max({p0.y, p1.y, p2.y}) + 1);
-
-                            for (std::int32_t y = minY; y < maxY; y++)
+                            tri.i0 = i0;
+                            tri.i1 = i1;
+                            tri.i2 = i2;
+                            tri.p0 = p0;
+                            tri.p1 = p1;
+                            tri.p2 = p2;
+                            tri.minX = std::max(0, std::min({p0.x, p1.x, p2.x}));
+                            tri.minY = std::max(0, std::min({p0.y, p1.y, p2.y}));
+                            tri.maxX = std::min((std::int32_t)width - 1, std::max({p0.x, p1.x, p2.x}) + 1);
+                            tri.maxY = std::min((std::int32_t)height - 1, std::max({p0.y, p1.y, p2.y}) + 1);
+                            if (tri.minX < tri.maxX && tri.minY < tri.maxY)
+                                binOffsets[i + 1] = ((tri.maxX - 1) / tileSize - tri.minX / tileSize + 1) * ((tri.maxY - 1) / tileSize - tri.minY / tileSize + 1);
+                        }
+                    },
+                    tbb::auto_partitioner()
+				);
+            });
+            std::inclusive_scan(binOffsets.begin(), binOffsets.end(), binOffsets.begin());
+            std::vector<std::uint32_t> binTiles(binOffsets.back());
+            std::vector<std::uint32_t> binTris(binOffsets.back());
+            tp->Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<UINT>(0, totalTris),
+                    [&](const tbb::blocked_range<UINT>& r) {
+                        for (UINT i = r.begin(); i != r.end(); ++i)
+                        {
+                            const BakeTriangle& tri = bakeTris[i];
+                            std::uint32_t bin = binOffsets[i];
+                            if (bin == binOffsets[i + 1])
+                                continue;
+                            for (std::int32_t ty = tri.minY / tileSize; ty <= (tri.maxY - 1) / tileSize; ty++)
                             {
-                                const float mY = static_cast<const float>(y) * invHeight;
-
-                                std::uint8_t* srcRowData = nullptr;
-                                if (hasSrcData)
-                                {
-                                    const float srcY = mY * srcHeightF;
-                                    srcRowData = srcData + static_cast<const UINT>(srcY) * srcmg.GetRowPitch();
-                                }
-
-                                std::uint8_t* detailRowData = nullptr;
-                                if (hasDetailData)
-                                {
-                                    const float detailY = mY * detailHeightF;
-                                    detailRowData = detailData + static_cast<const UINT>(detailY) * detailmg.GetRowPitch();
-                                }
-
-                                std::uint8_t* overlayRowData = nullptr;
-                                if (hasOverlayData)
-                                {
-                                    const float overlayY = mY * overlayHeightF;
-                                    overlayRowData = overlayData + static_cast<const UINT>(overlayY) * overlaymg.GetRowPitch();
-                                }
-
-                                std::uint8_t* maskRowData = nullptr;
-                                if (hasMaskData)
+                                for (std::int32_t tx = tri.minX / tileSize; tx <= (tri.maxX - 1) / tileSize; tx++, bin++)
                                 {
-                                    const float maskY = mY * maskHeightF;
-                                    maskRowData = maskData + static_cast<const UINT>(maskY) * maskmg.GetRowPitch();
+                                    binTiles[bin] = ty * tilesX + tx;
+                                    binTris[bin] = i;
                                 }
+                            }
+                        }
+                    },
+                    tbb::auto_partitioner()
+                );
+            });
+            GeometryKernel::AdjacencyList tileBins; // bins of each tile in the bake order
+            tileBins.Build(std::size_t(tilesX) * tilesY, binTiles, 1, tp.get());
 
-                                std::uint8_t* rowData = dstData + y * dstmg.GetRowPitch();
-                                for (std::int32_t x = minX; x < maxX; x++)
-                                {
-                                    DirectX::XMFLOAT3 bary;
-                                    if (!ComputeBarycentric(static_cast<const float>(x) + 0.5f, static_cast<const float>(y) + 0.5f, p0, p1, p2, bary))
-                                        continue;
-
-                                    const float mX = x * invWidth;
-
-                                    RGBA dstColor;
-                                    RGBA overlayColor(1.0f, 1.0f, 1.0f, 0.0f);
-                                    if (hasOverlayData)
-                                    {
-                                        const float overlayX = mX * overlayWidthF;
-                                        const std::uint32_t* overlayPixel = reinterpret_cast<std::uint32_t*>(overlayRowData + static_cast<const UINT>(overlayX) * 4);
-                                        overlayColor.SetReverse(*overlayPixel);
-                                    }
-                                    if (overlayColor.a < 1.0f)
-                                    {
-                                        RGBA maskColor(1.0f, 1.0f, 1.0f, 0.0f);
-                                        if (hasMaskData && hasSrcData)
-                                        {
-                                            const float maskX = mX * maskWidthF;
-                                            const std::uint32_t* maskPixel = reinterpret_cast<std::uint32_t*>(maskRowData + static_cast<const UINT>(maskX) * 4);
-                                            maskColor.SetReverse(*maskPixel);
-                                        }
-                                        if (maskColor.a < 1.0f)
-                                        {
-                                            RGBA detailColor(0.5f, 0.5f, 1.0f, 0.5f);
-                                            if (hasDetailData)
-                                            {
-                                                const float detailX = mX * detailWidthF;
-                                                const std::uint32_t* detailPixel = reinterpret_cast<std::uint32_t*>(detailRowData + static_cast<const UINT>(detailX) * 4);
-                                                detailColor.SetReverse(*detailPixel);
-                                                detailColor = RGBA::lerp(RGBA(0.5f, 0.5f, 1.0f, detailColor.a), detailColor, detailStrength);
-                                            }
-
-                                            const float denomal = (bary.x + bary.y + floatPrecision);
-                                            const DirectX::XMVECTOR n01 = SlerpVector(n0v, n1v, bary.y / denomal);
-                                            const DirectX::XMVECTOR n = SlerpVector(n01, n2v, bary.z);
+            tp->Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, std::size_t(tilesX) * tilesY),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                        std::vector<GeometryKernel::RasterSpan> spans;
+                        for (std::size_t tile = r.begin(); tile != r.end(); ++tile)
+                        {
+                            const std::int32_t tileMinX = static_cast<std::int32_t>(tile % tilesX) * tileSize;
+                            const std::int32_t tileMinY = static_cast<std::int32_t>(tile / tilesX) * tileSize;
+                            const std::int32_t tileMaxX = std::min(tileMinX + tileSize, (std::int32_t)width);
+                            const std::int32_t tileMaxY = std::min(tileMinY + tileSize, (std::int32_t)height);
 
-                                            DirectX::XMVECTOR normalResult = emptyVector;
-                                            if (detailColor.a > 0.0f)
-                                            {
-                                                const DirectX::XMVECTOR t01 = SlerpVector(t0v, t1v, bary.y / denomal);
-                                                const DirectX::XMVECTOR t = SlerpVector(t01, t2v, bary.z);
-
-                                                const DirectX::XMVECTOR b01 = SlerpVector(b0v, b1v, bary.y / denomal);
-                                                const DirectX::XMVECTOR b = SlerpVector(b01, b2v, bary.z);
-
-                                                const DirectX::XMVECTOR ft = DirectX::XMVector3NormalizeEst(
-                                                    DirectX::XMVectorSubtract(t, DirectX::XMVectorScale(n, DirectX::XMVectorGetX(DirectX::XMVector3Dot(n, t)))));
-                                                const DirectX::XMVECTOR fb = DirectX::XMVector3NormalizeEst(DirectX::XMVector3Cross(n, ft));
-
-                                                const DirectX::XMMATRIX tbn = DirectX::XMMATRIX(ft, fb, n, DirectX::XMVectorSet(0, 0, 0, 1));
-
-                                                const DirectX::XMFLOAT4 detailColorF(
-                                                    detailColor.r * 2.0f - 1.0f,
-                                                    detailColor.g * 2.0f - 1.0f,
-                                                    detailColor.b * 2.0f - 1.0f,
-                                                    0.0f);
-                                                const DirectX::XMVECTOR detailNormalVec = DirectX::XMVectorSet(
-                                                    detailColorF.x,
-                                                    detailColorF.y,
-                                                    tangentZCorrection ? std::sqrt(std::max(0.0f, 1.0f - detailColorF.x * detailColorF.x - detailColorF.y * detailColorF.y)) : detailColorF.z,
-                                                    0.0f);
-
-                                                const DirectX::XMVECTOR detailNormal = DirectX::XMVector3NormalizeEst(
-                                                    DirectX::XMVector3TransformNormal(detailNormalVec, tbn));
-                                                normalResult = DirectX::XMVector3NormalizeEst(
-                                                    DirectX::XMVectorLerp(n, detailNormal, detailColor.a));
-                                            }
-                                            else
-                                            {
-                                                normalResult = n;
-                                            }
-                                            const DirectX::XMVECTOR normalVec = DirectX::XMVectorMultiplyAdd(normalResult, halfVec, halfVec);
-                                            dstColor = RGBA(DirectX::XMVectorGetX(normalVec), DirectX::XMVectorGetZ(normalVec), DirectX::XMVectorGetY(normalVec));
-                                        }
-                                        if (maskColor.a > 0.0f && hasSrcData)
-                                        {
-                                            const float srcX = mX * srcWidthF;
-                                            const std::uint32_t* srcPixel = reinterpret_cast<std::uint32_t*>(srcRowData + static_cast<const UINT>(srcX) * 4);
-                                            RGBA srcColor;
-                                            srcColor.SetReverse(*srcPixel);
-                                            dstColor = RGBA::lerp(dstColor, srcColor, maskColor.a);
-                                        }
-                                    }
-                                    if (overlayColor.a > 0.0f)
-                                    {
-                                        dstColor = RGBA::lerp(dstColor, overlayColor, overlayColor.a);
-                                    }
+                            // init dst texture
+                            for (std::int32_t y = tileMinY; y < tileMaxY; y++)
+                            {
+                                std::uint32_t* pixel = reinterpret_cast<uint32_t*>(dstData + y * dstmg.GetRowPitch()) + tileMinX;
+                                std::fill(pixel, pixel + (tileMaxX - tileMinX), emptyColor.GetReverse());
+                            }
 
-                                    std::uint32_t* dstPixel = reinterpret_cast<std::uint32_t*>(rowData + x * 4);
-                                    *dstPixel = dstColor.GetReverse() | 0xFF000000;
-                                }
+                            for (const std::uint32_t bin : tileBins[tile])
+                            {
+                                const BakeTriangle& tri = bakeTris[binTris[bin]];
+                                rasterize(tri, std::max(tri.minX, tileMinX), std::max(tri.minY, tileMinY), std::min(tri.maxX, tileMaxX), std::min(tri.maxY, tileMaxY), spans);
                             }
                         }
                     },
                     tbb::auto_partitioner()
-				);
+                );
             });
             if (Config::GetSingleton().GetUpdateNormalMapTime2())
                 PerformanceLog(std::string(_func_) + "::" + GetHexStr(a_actorID) + "::" + update.second.geometryName, true, false);
@@ -800,7 +954,7 @@ namespace Mus {
             results.push_back(newNormalMapResult);
             resourceDatas.push_back(newResourceData);
         }
-		PostProcessing(device, context, resourceDatas, results, mergedTextureGeometries);
+		PostProcessing(a_actorID, device, context, resourceDatas, results, mergedTextureGeometries);
 		return results;
 	}
 
@@ -841,9 +995,12 @@ namespace Mus {
 
 		MergedTextureGeometries mergedTextureGeometries;
         ResourceDatas resourceDatas;
-		LoadCacheResource(a_actorID, a_data, a_updateSet, mergedTextureGeometries, resourceDatas, results);
+		NormalMapStore::BakeGuard bakeGuard;
+		LoadCacheResource(a_actorID, a_data, a_updateSet, mergedTextureGeometries, resourceDatas, results, bakeGuard);
 
         const bool tangentZCorrection = Config::GetSingleton().GetTangentZCorrection();
+        const bool nlerp = Config::GetSingleton().GetNormalInterpolation() == Config::NormalInterpolationList::Nlerp;
+        const bool orthogonalizeTangent = Config::GetSingleton().GetOrthogonalizeTangent();
 
         for (const auto& update : a_updateSet)
         {
@@ -864,6 +1021,7 @@ namespace Mus {
             TextureResourceDataPtr newResourceData = std::make_shared<TextureResourceData>();
             newResourceData->geometry = update.first;
             newResourceData->textureName = update.second.textureName;
+            newResourceData->arena = a_data->arena;
 
             D3D11_TEXTURE2D_DESC srcDesc = {}, detailDesc = {}, overlayDesc = {}, maskDesc = {}, dstDesc = {};
             D3D11_SHADER_RESOURCE_VIEW_DESC dstShaderResourceViewDesc = {};
@@ -984,6 +1142,8 @@ namespace Mus {
             cbData.tangentZCorrection = tangentZCorrection ? 1 : 0;
             cbData.detailStrength = update.second.detailStrength;
             cbData.vertexEnd = a_data->vertices.size();
+            cbData.nlerp = nlerp ? 1 : 0;
+            cbData.orthogonalizeTangent = orthogonalizeTangent ? 1 : 0;
             
             const std::uint32_t totalTris = objInfo.indicesCount() / 3;
             if (sl.IsSecondGPU() || isNoSplitGPU)
@@ -1099,7 +1259,7 @@ namespace Mus {
             results.push_back(newNormalMapResult);
             resourceDatas.push_back(newResourceData);
         }
-		PostProcessingGPU(device, context, resourceDatas, results, mergedTextureGeometries);
+		PostProcessingGPU(a_actorID, device, context, resourceDatas, results, mergedTextureGeometries);
 		return results;
 	}
 
@@ -1153,82 +1313,35 @@ namespace Mus {
 		return LoadTexture(device, context, filePath, texDesc, srvDesc, texOutput, srvOutput);
 	}
 
-	bool ObjectNormalMapUpdater::LoadTextureCPU(ID3D11Device* device, ID3D11DeviceContext* context, const std::string& filePath, D3D11_TEXTURE2D_DESC& texDesc, Microsoft::WRL::ComPtr<ID3D11Texture2D>& output)
+	bool ObjectNormalMapUpdater::LoadTextureCPU(ID3D11Device* device, ID3D11DeviceContext* context, const std::string& filePath, UINT minWidth, UINT minHeight, Shader::TextureCPUCache::ImagePtr& output)
 	{
 		if (!device || !context || filePath.empty())
 			return false;
 
-		HRESULT hr;
-		D3D11_SHADER_RESOURCE_VIEW_DESC tmpSRVDesc;
-		Microsoft::WRL::ComPtr<ID3D11Texture2D> texture;
-		if (Shader::ShaderManager::GetSingleton().IsSecondGPUResource(context))
-		{
-			if (!Shader::TextureLoadManager::GetSingleton().GetTextureFromFile(device, context, filePath, texDesc, tmpSRVDesc, DXGI_FORMAT_R8G8B8A8_UNORM, true, texture))
-				return false;
-		}
-		else
-		{
-			if (!Shader::TextureLoadManager::GetSingleton().GetTexture2D(filePath, texDesc, tmpSRVDesc, DXGI_FORMAT_R8G8B8A8_UNORM, true, texture))
-				return false;
-		}
-		texture->GetDesc(&texDesc);
-		if (texDesc.CPUAccessFlags & D3D11_CPU_ACCESS_READ)
-		{
-			output = texture;
+		constexpr DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		if (output = Shader::TextureCPUCache::GetSingleton().Get(filePath, format, minWidth, minHeight); output)
 			return true;
-		}
-		texDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
-		texDesc.Usage = D3D11_USAGE_STAGING;
-		texDesc.MiscFlags = 0;
-		texDesc.BindFlags = 0;
-		hr = device->CreateTexture2D(&texDesc, nullptr, output.GetAddressOf());
-		if (FAILED(hr))
-		{
-			logger::error("Failed to create texture 2d ({})", hr);
-			return false;
-		}
-		return CopySubresourceRegion(device, context, output.Get(), texture.Get(), 0, 0);
-	}
-
-	DirectX::XMVECTOR ObjectNormalMapUpdater::SlerpVector(const DirectX::XMVECTOR& a, const DirectX::XMVECTOR& b, const float& t)
-	{
-		const float dotAB = std::clamp(DirectX::XMVectorGetX(DirectX::XMVector3Dot(a, b)), -1.0f, 1.0f);
-		const float theta = acosf(dotAB) * t;
-		const DirectX::XMVECTOR relVec = DirectX::XMVector3NormalizeEst(
-			DirectX::XMVectorSubtract(b, DirectX::XMVectorScale(a, dotAB))
-		);
-		return DirectX::XMVector3NormalizeEst(
-			DirectX::XMVectorAdd(
-				DirectX::XMVectorScale(a, cosf(theta)),
-				DirectX::XMVectorScale(relVec, sinf(theta))
-			)
-		);
-	}
 
-	bool ObjectNormalMapUpdater::ComputeBarycentric(const float& px, const float& py, const DirectX::XMINT2& a, const DirectX::XMINT2& b, const DirectX::XMINT2& c, DirectX::XMFLOAT3& out)
-	{
-        const DirectX::SimpleMath::Vector2 v0 = {static_cast<const float>(b.x - a.x), static_cast<const float>(b.y - a.y)};
-        const DirectX::SimpleMath::Vector2 v1 = {static_cast<const float>(c.x - a.x), static_cast<const float>(c.y - a.y)};
-        const DirectX::SimpleMath::Vector2 v2 = {px - a.x, py - a.y};
-
-		const float d00 = v0.Dot(v0);
-		const float d01 = v0.Dot(v1);
-		const float d11 = v1.Dot(v1);
-		const float d20 = v2.Dot(v0);
-		const float d21 = v2.Dot(v1);
-		const float denom = d00 * d11 - d01 * d01;
-
-		if (denom == 0.0f)
+		DirectX::ScratchImage scratch;
+		const bool fromFile = Shader::ShaderManager::GetSingleton().IsSecondGPUResource(context);
+		if (!Shader::TextureLoadManager::GetSingleton().GetTextureImage(filePath, format, minWidth, minHeight, fromFile, scratch))
 			return false;
-
-		const float v = (d11 * d20 - d01 * d21) / denom;
-		const float w = (d00 * d21 - d01 * d20) / denom;
-		const float u = 1.0f - v - w;
-
-		if (u < 0 || v < 0 || w < 0)
+		const DirectX::Image* mip = scratch.GetImage(0, 0, 0);
+		if (!mip)
 			return false;
 
-		out = { u, v, w };
+		auto image = std::make_shared<Shader::TextureCPUCache::Image>();
+		image->width = static_cast<UINT>(mip->width);
+		image->height = static_cast<UINT>(mip->height);
+		image->rowPitch = image->width * 4;
+		image->format = format;
+		image->pixels.resize(static_cast<std::size_t>(image->rowPitch) * image->height);
+		for (UINT y = 0; y < image->height; y++)
+		{
+			std::memcpy(image->pixels.data() + static_cast<std::size_t>(y) * image->rowPitch, mip->pixels + y * mip->rowPitch, image->rowPitch);
+		}
+		Shader::TextureCPUCache::GetSingleton().Insert(filePath, format, minWidth, minHeight, image);
+		output = image;
 		return true;
 	}
 
@@ -1485,8 +1598,9 @@ namespace Mus {
 		return true;
 	}
 
-	void ObjectNormalMapUpdater::PostProcessing(ID3D11Device *device, ID3D11DeviceContext *context, ResourceDatas &resourceDatas, UpdateResult &results, MergedTextureGeometries &mergedTextureGeometries)
+	void ObjectNormalMapUpdater::PostProcessing(RE::FormID a_actorID, ID3D11Device *device, ID3D11DeviceContext *context, ResourceDatas &resourceDatas, UpdateResult &results, MergedTextureGeometries &mergedTextureGeometries)
 	{
+		const bool isReplay = a_actorID == replayActorID;
 		//merge texture
 		{
 			bool merged = false;
@@ -1522,7 +1636,8 @@ namespace Mus {
 						src.texture = dst.texture;
 						mergedTextureGeometries.insert(src.geometry);
 						merged = true;
-						NormalMapStore::GetSingleton().AddHashPair(dst.hash, src.hash);
+						if (!isReplay)
+							NormalMapStore::GetSingleton().AddHashPair(dst.hash, src.hash);
 					}
 				}
 			}
@@ -1598,14 +1713,16 @@ namespace Mus {
                     resourceDataMap.push_back(resourceData);
                 }
                 logger::info("{} : normalmap created", result.textureName, result.geoName);
-                NormalMapStore::GetSingleton().AddResource(result.hash, result.texture);
+                if (!isReplay)
+                    NormalMapStore::GetSingleton().AddResource(result.hash, result.texture);
             }
             else
             {
                 if (CopyResourceSecondToMain(resourceData, result.texture->normalmapTexture2D, result.texture->normalmapShaderResourceView))
                 {
                     logger::info("{} : normalmap created", result.textureName, result.geoName);
-                    NormalMapStore::GetSingleton().AddResource(result.hash, result.texture);
+                    if (!isReplay)
+                        NormalMapStore::GetSingleton().AddResource(result.hash, result.texture);
                 }
                 else
                     failedCopyResources.insert(result.geometry);
@@ -1615,8 +1732,9 @@ namespace Mus {
             return failedCopyResources.find(result.geometry) != failedCopyResources.end();
         });
 	}
-    void ObjectNormalMapUpdater::PostProcessingGPU(ID3D11Device* device, ID3D11DeviceContext* context, ResourceDatas& resourceDatas, UpdateResult& results, MergedTextureGeometries& mergedTextureGeometries)
+    void ObjectNormalMapUpdater::PostProcessingGPU(RE::FormID a_actorID, ID3D11Device* device, ID3D11DeviceContext* context, ResourceDatas& resourceDatas, UpdateResult& results, MergedTextureGeometries& mergedTextureGeometries)
     {
+        const bool isReplay = a_actorID == replayActorID;
         // merge texture
         {
             bool merged = false;
@@ -1652,7 +1770,8 @@ namespace Mus {
                         src.texture = dst.texture;
                         mergedTextureGeometries.insert(src.geometry);
                         merged = true;
-                        NormalMapStore::GetSingleton().AddHashPair(dst.hash, src.hash);
+                        if (!isReplay)
+                            NormalMapStore::GetSingleton().AddHashPair(dst.hash, src.hash);
                     }
                 }
             }
@@ -1728,14 +1847,16 @@ namespace Mus {
                     resourceDataMap.push_back(resourceData);
                 }
                 logger::info("{} : normalmap created", result.textureName, result.geoName);
-                NormalMapStore::GetSingleton().AddResource(result.hash, result.texture);
+                if (!isReplay)
+                    NormalMapStore::GetSingleton().AddResource(result.hash, result.texture);
             }
             else
             {
                 if (CopyResourceSecondToMain(resourceData, result.texture->normalmapTexture2D, result.texture->normalmapShaderResourceView))
                 {
                     logger::info("{} : normalmap created", result.textureName, result.geoName);
-                    NormalMapStore::GetSingleton().AddResource(result.hash, result.texture);
+                    if (!isReplay)
+                        NormalMapStore::GetSingleton().AddResource(result.hash, result.texture);
                 }
                 else
                     failedCopyResources.insert(result.geometry);
@@ -2022,7 +2143,7 @@ namespace Mus {
                     tbb::auto_partitioner()
 				);
             });
-			std::vector<ColorMap> resultsColorMap;
+			std::pmr::vector<ColorMap> resultsColorMap(resourceData->arena ? resourceData->arena->Get() : std::pmr::get_default_resource());
             for (auto& process : colorMapProcesses)
 			{
                 resultsColorMap.append_range(process.data);
@@ -2607,7 +2728,7 @@ namespace Mus {
                     tbb::blocked_range<UINT>(0, bc7Height),
                     [&](const tbb::blocked_range<UINT>& r) {
                         const std::uint32_t blockCount = (r.end() - r.begin()) * bc7Width;
-                        std::vector<std::uint32_t> pixelsLocal(blockCount * 16);
+                        std::pmr::vector<std::uint32_t> pixelsLocal(blockCount * 16, resourceData->arena ? resourceData->arena->Get() : std::pmr::get_default_resource());
                         std::uint32_t* pixels = pixelsLocal.data();
                         std::size_t pixelIndex = 0;
                         std::uint64_t* dstBlocks = reinterpret_cast<std::uint64_t*>(bc7Buffers[mipLevel].data()) + (r.begin() * bc7Width * 2);
@@ -0,0 +1,44 @@
+#include "ScratchArena.h"
+
+namespace Mus {
+    std::pmr::memory_resource* ScratchArena::Get()
+    {
+        // a worker can serve several updates in turn, so it remembers the last few arenas. ids are never reused
+        struct CacheEntry {
+            std::uint64_t id = 0;
+            SubArena* subArena = nullptr;
+        };
+        thread_local std::array<CacheEntry, threadCacheSize> cache = {};
+        thread_local std::size_t nextSlot = 0;
+        for (const auto& entry : cache)
+        {
+            if (entry.id == id)
+                return &entry.subArena->pool;
+        }
+
+        std::lock_guard lg(lock);
+        auto& subArena = subArenas[std::this_thread::get_id()];
+        if (!subArena)
+            subArena = std::make_unique<SubArena>(largestBlock, &upstream);
+        cache[nextSlot] = {id, subArena.get()};
+        nextSlot = (nextSlot + 1) % threadCacheSize;
+        return &subArena->pool;
+    }
+
+    void* ScratchArena::CountingResource::do_allocate(std::size_t bytes, std::size_t alignment)
+    {
+        void* p = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        const std::size_t current = usage.fetch_add(bytes) + bytes;
+        std::size_t prevPeak = peak.load();
+        while (prevPeak < current && !peak.compare_exchange_weak(prevPeak, current))
+        {
+        }
+        return p;
+    }
+
+    void ScratchArena::CountingResource::do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        usage.fetch_sub(bytes);
+    }
+}
@@ -774,32 +774,9 @@ namespace Mus {
 		
 		bool TextureLoadManager::GetTexture2D(std::string filePath, D3D11_TEXTURE2D_DESC& textureDesc, D3D11_SHADER_RESOURCE_VIEW_DESC& srvDesc, DXGI_FORMAT newFormat, UINT newWidth, UINT newHeight, bool cpuReadable, Microsoft::WRL::ComPtr<ID3D11Texture2D>& output)
 		{
-			filePath = stringRemoveStarts(filePath, "Data\\");
-			if (!stringStartsWith(filePath, "textures"))
-				filePath = "Textures\\" + filePath;
-
-			if (!IsExistFileInStream(filePath, ExistType::textures))
-			{
-				logger::error("Failed to load texture file : {}", filePath);
-				return false;
-			}
-			RE::NiPointer<RE::NiSourceTexture> sourceTexture;
-			LoadTexture(filePath.c_str(), 1, sourceTexture, false);
-			if (!sourceTexture || !sourceTexture->rendererTexture || !sourceTexture->rendererTexture->resourceView)
-			{
-				logger::error("Failed to load texture file : {}", filePath);
-				return false;
-			}
-			Microsoft::WRL::ComPtr<ID3D11Resource> resource;
-			sourceTexture->rendererTexture->resourceView->GetDesc(&srvDesc);
-			sourceTexture->rendererTexture->resourceView->GetResource(&resource);
 			Microsoft::WRL::ComPtr<ID3D11Texture2D> texture2D;
-			HRESULT hr = resource.As(&texture2D);
-			if (FAILED(hr))
-			{
-				logger::error("Failed to load texture resource ({})", hr);
+			if (!GetSourceTexture2D(filePath, srvDesc, texture2D))
 				return false;
-			}
 			texture2D->GetDesc(&textureDesc);
 			if (newFormat == DXGI_FORMAT_UNKNOWN && newWidth == 0 && newHeight == 0)
 			{
@@ -841,30 +818,10 @@ namespace Mus {
 		{
 			if (!device)
 				return false;
-			if (!stringEndsWith(filePath, ".dds"))
-				return false;
-			if (!stringStartsWith(filePath, "Textures"))
-				filePath = "Textures\\" + filePath;
-			filePath = stringRemoveStarts(filePath, "Data\\");
-
-			RE::BSResourceNiBinaryStream file(filePath);
-            if (!file.good() || !file.stream)
-				return false;
-
-			auto ec = file.stream->DoOpen();
-            if (ec != RE::BSResource::ErrorCode::kNone)
-                return false;
-
-			std::vector<std::uint8_t> buffer(file.stream->totalSize);
-            std::uint64_t readBytes;
-            file.stream->DoRead(buffer.data(), buffer.size(), readBytes);
-			
 			DirectX::ScratchImage image;
-            HRESULT hr = LoadFromDDSMemory(buffer.data(), buffer.size(), DirectX::DDS_FLAGS::DDS_FLAGS_NONE, nullptr, image);
-			if (FAILED(hr)) {
-				logger::error("Failed to get texture from {} file ({})", filePath, hr);
+			if (!ReadDDSFile(filePath, image))
 				return false;
-			}
+			HRESULT hr;
 			Microsoft::WRL::ComPtr<ID3D11Resource> resource;
 			if (!ConvertD3D11(device, image, cpuReadable, resource))
 			{
@@ -918,12 +875,111 @@ namespace Mus {
 			return GetTextureFromFile(device, context, filePath, tmpTexDesc, tmpSRVDesc, newFormat, cpuReadable, output);
 		}
 
+		bool TextureLoadManager::GetTextureImage(std::string filePath, DXGI_FORMAT newFormat, UINT minWidth, UINT minHeight, bool fromFile, DirectX::ScratchImage& output)
+		{
+			DirectX::ScratchImage image;
+			HRESULT hr;
+			if (fromFile)
+			{
+				DirectX::ScratchImage file;
+				if (!ReadDDSFile(filePath, file))
+					return false;
+				const auto& metadata = file.GetMetadata();
+				const UINT mipLevel = GetMatchedMipLevel(static_cast<UINT>(metadata.width), static_cast<UINT>(metadata.height), static_cast<UINT>(metadata.mipLevels), minWidth, minHeight);
+				hr = image.InitializeFromImage(*file.GetImage(mipLevel, 0, 0));
+				if (FAILED(hr))
+				{
+					logger::error("Failed to get mip {} of {} ({})", mipLevel, filePath, hr);
+					return false;
+				}
+			}
+			else
+			{
+				auto device = ShaderManager::GetSingleton().GetDevice();
+				auto context = ShaderManager::GetSingleton().GetContext();
+				if (!device || !context)
+					return false;
+
+				D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+				Microsoft::WRL::ComPtr<ID3D11Texture2D> texture2D;
+				if (!GetSourceTexture2D(filePath, srvDesc, texture2D))
+					return false;
+				D3D11_TEXTURE2D_DESC textureDesc;
+				texture2D->GetDesc(&textureDesc);
+				const UINT mipLevel = GetMatchedMipLevel(textureDesc.Width, textureDesc.Height, textureDesc.MipLevels, minWidth, minHeight);
+
+				D3D11_TEXTURE2D_DESC mipDesc = {};
+				mipDesc.Width = std::max(1u, textureDesc.Width >> mipLevel);
+				mipDesc.Height = std::max(1u, textureDesc.Height >> mipLevel);
+				mipDesc.MipLevels = 1;
+				mipDesc.ArraySize = 1;
+				mipDesc.Format = textureDesc.Format;
+				mipDesc.SampleDesc.Count = 1;
+				mipDesc.Usage = D3D11_USAGE_STAGING;
+				mipDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+				Microsoft::WRL::ComPtr<ID3D11Texture2D> mipTexture;
+				hr = device->CreateTexture2D(&mipDesc, nullptr, &mipTexture);
+				if (FAILED(hr))
+				{
+					logger::error("Failed to create staging texture for mip {} of {} ({})", mipLevel, filePath, hr);
+					return false;
+				}
+
+				Shader::ShaderLocker sl(context);
+				{
+					Shader::ShaderLockGuard slg(sl);
+					context->CopySubresourceRegion(mipTexture.Get(), 0, 0, 0, 0, texture2D.Get(), D3D11CalcSubresource(mipLevel, 0, textureDesc.MipLevels), nullptr);
+					hr = DirectX::CaptureTexture(device, context, mipTexture.Get(), image);
+				}
+				if (FAILED(hr))
+				{
+					logger::error("Failed to decoding texture ({})", hr);
+					return false;
+				}
+			}
+
+			if (newFormat == DXGI_FORMAT_UNKNOWN || image.GetMetadata().format == newFormat)
+			{
+				output = std::move(image);
+				return true;
+			}
+			hr = DirectX::Decompress(image.GetImages(), image.GetImageCount(), image.GetMetadata(), newFormat, output);
+			if (FAILED(hr))
+			{
+				hr = DirectX::Convert(image.GetImages(), image.GetImageCount(), image.GetMetadata(), newFormat, DirectX::TEX_FILTER_FANT, 0.0f, output);
+				if (FAILED(hr))
+				{
+					logger::error("Failed to convert texture {} to {} ({})", magic_enum::enum_name(image.GetMetadata().format).data(), magic_enum::enum_name(newFormat).data(), hr);
+					return false;
+				}
+			}
+			return true;
+		}
+
+		UINT TextureLoadManager::GetMatchedMipLevel(UINT width, UINT height, UINT mipLevels, UINT minWidth, UINT minHeight)
+		{
+			if (minWidth == 0 || minHeight == 0)
+				return 0;
+			UINT mipLevel = 0;
+			while (mipLevel + 1 < mipLevels)
+			{
+				const UINT mipWidth = width >> (mipLevel + 1);
+				const UINT mipHeight = height >> (mipLevel + 1);
+				// block compressed mips stay whole blocks
+				if (mipWidth < minWidth || mipHeight < minHeight || mipWidth % 4 != 0 || mipHeight % 4 != 0)
+					break;
+				mipLevel++;
+			}
+			return mipLevel;
+		}
+
 		bool TextureLoadManager::UpdateTexture(std::string filePath)
 		{
 			filePath = stringRemoveStarts(filePath, "Data\\");
 			if (!stringStartsWith(filePath, "textures"))
 				filePath = "Textures\\" + filePath;
 			filePath = FixPath(filePath);
+			TextureCPUCache::GetSingleton().Remove(filePath);
 
 			if (!UpdateNiTexture(filePath))
 				return false;
@@ -1059,6 +1115,87 @@ namespace Mus {
 			output = tmpTexture;
 			return true;
 		}
+		bool TextureLoadManager::GetSourceTexture2D(std::string filePath, D3D11_SHADER_RESOURCE_VIEW_DESC& srvDesc, Microsoft::WRL::ComPtr<ID3D11Texture2D>& output)
+		{
+			filePath = stringRemoveStarts(filePath, "Data\\");
+			if (!stringStartsWith(filePath, "textures"))
+				filePath = "Textures\\" + filePath;
+
+			if (!IsExistFileInStream(filePath, ExistType::textures))
+			{
+				logger::error("Failed to load texture file : {}", filePath);
+				return false;
+			}
+			RE::NiPointer<RE::NiSourceTexture> sourceTexture;
+			LoadTexture(filePath.c_str(), 1, sourceTexture, false);
+			if (!sourceTexture || !sourceTexture->rendererTexture || !sourceTexture->rendererTexture->resourceView)
+			{
+				logger::error("Failed to load texture file : {}", filePath);
+				return false;
+			}
+			Microsoft::WRL::ComPtr<ID3D11Resource> resource;
+			sourceTexture->rendererTexture->resourceView->GetDesc(&srvDesc);
+			sourceTexture->rendererTexture->resourceView->GetResource(&resource);
+			HRESULT hr = resource.As(&output);
+			if (FAILED(hr))
+			{
+				logger::error("Failed to load texture resource ({})", hr);
+				return false;
+			}
+			return true;
+		}
+		bool TextureLoadManager::ReadDDSFile(std::string filePath, DirectX::ScratchImage& output)
+		{
+			if (!stringEndsWith(filePath, ".dds"))
+				return false;
+			if (!stringStartsWith(filePath, "Textures"))
+				filePath = "Textures\\" + filePath;
+			filePath = stringRemoveStarts(filePath, "Data\\");
+
+			RE::BSResourceNiBinaryStream file(filePath);
+            if (!file.good() || !file.stream)
+				return false;
+
+			auto ec = file.stream->DoOpen();
+            if (ec != RE::BSResource::ErrorCode::kNone)
+                return false;
+
+			std::vector<std::uint8_t> buffer(file.stream->totalSize);
+            std::uint64_t readBytes;
+            file.stream->DoRead(buffer.data(), buffer.size(), readBytes);
+			
+            HRESULT hr = LoadFromDDSMemory(buffer.data(), buffer.size(), DirectX::DDS_FLAGS::DDS_FLAGS_NONE, nullptr, output);
+			if (FAILED(hr)) {
+				logger::error("Failed to get texture from {} file ({})", filePath, hr);
+				return false;
+			}
+			return true;
+		}
+		bool TextureLoadManager::GetTextureSize(std::string filePath, UINT& width, UINT& height)
+		{
+			if (!stringEndsWith(filePath, ".dds"))
+				return false;
+			if (!stringStartsWith(filePath, "Textures"))
+				filePath = "Textures\\" + filePath;
+			filePath = stringRemoveStarts(filePath, "Data\\");
+
+			RE::BSResourceNiBinaryStream file(filePath);
+			if (!file.good() || !file.stream)
+				return false;
+			if (file.stream->DoOpen() != RE::BSResource::ErrorCode::kNone)
+				return false;
+
+			// magic + DDS_HEADER + DDS_HEADER_DXT10
+			std::uint8_t buffer[4 + 124 + 20] = {};
+			std::uint64_t readBytes = 0;
+			file.stream->DoRead(buffer, std::min<std::uint64_t>(sizeof(buffer), file.stream->totalSize), readBytes);
+			DirectX::TexMetadata metadata;
+			if (FAILED(DirectX::GetMetadataFromDDSMemory(buffer, static_cast<std::size_t>(readBytes), DirectX::DDS_FLAGS::DDS_FLAGS_NONE, metadata)))
+				return false;
+			width = static_cast<UINT>(metadata.width);
+			height = static_cast<UINT>(metadata.height);
+			return true;
+		}
 		bool TextureLoadManager::ConvertD3D11(ID3D11Device* device, DirectX::ScratchImage& image, bool cpuReadabl, Microsoft::WRL::ComPtr<ID3D11Resource>& output)
 		{
 			// convert texture to d3d11 texture
@@ -1169,5 +1306,80 @@ namespace Mus {
 			texInOut = tmpTexture;
 			return true;
 		}
+
+		TextureCPUCache::ImagePtr TextureCPUCache::Get(const std::string& filePath, DXGI_FORMAT format, UINT minWidth, UINT minHeight)
+		{
+			const CacheKey key = {GetFileKey(filePath), format, minWidth, minHeight};
+			std::lock_guard lg(lock);
+			auto found = map.find(key);
+			if (found == map.end())
+			{
+				missCount++;
+				return nullptr;
+			}
+			hitCount++;
+			lru.splice(lru.begin(), lru, found->second.lruIt);
+			return found->second.image;
+		}
+
+		void TextureCPUCache::Insert(const std::string& filePath, DXGI_FORMAT format, UINT minWidth, UINT minHeight, ImagePtr image)
+		{
+			const std::size_t maxBytes = static_cast<std::size_t>(Config::GetSingleton().GetSourceTextureCacheSize()) * 1024 * 1024;
+			if (!image || image->pixels.size() > maxBytes)
+				return;
+			const CacheKey key = {GetFileKey(filePath), format, minWidth, minHeight};
+			std::lock_guard lg(lock);
+			if (auto found = map.find(key); found != map.end())
+			{
+				// decoded twice by bakes running at the same time, the first one stays
+				lru.splice(lru.begin(), lru, found->second.lruIt);
+				return;
+			}
+			lru.push_front(key);
+			map[key] = {image, lru.begin()};
+			usage += image->pixels.size();
+			while (usage > maxBytes)
+			{
+				auto oldest = map.find(lru.back());
+				usage -= oldest->second.image->pixels.size();
+				map.erase(oldest);
+				lru.pop_back();
+			}
+			logger::debug("{} : {} cached, {}MB in use, hit rate {:.1f}%", __func__, key.file, usage / (1024 * 1024), GetHitRate() * 100.0);
+		}
+
+		void TextureCPUCache::Remove(const std::string& filePath)
+		{
+			const std::string file = GetFileKey(filePath);
+			std::lock_guard lg(lock);
+			for (auto it = map.begin(); it != map.end();)
+			{
+				if (it->first.file != file)
+				{
+					it++;
+					continue;
+				}
+				usage -= it->second.image->pixels.size();
+				lru.erase(it->second.lruIt);
+				it = map.erase(it);
+			}
+		}
+
+		void TextureCPUCache::Clear()
+		{
+			std::lock_guard lg(lock);
+			map.clear();
+			lru.clear();
+			usage = 0;
+		}
+
+		std::string TextureCPUCache::GetFileKey(const std::string& filePath)
+		{
+			std::string file = lowLetter(FixPath(filePath));
+			file = stringRemoveStarts(file, "data\\");
+			if (!stringStartsWith(file, "textures"))
+				file = "textures\\" + file;
+			return file;
+		}
 	}
 }
@@ -0,0 +1,260 @@
+#include "Snapshot.h"
+
+namespace Mus {
+    namespace Snapshot {
+        namespace {
+            inline std::uint64_t AlignUp(std::uint64_t a_value, std::uint64_t a_alignment) {
+                return (a_value + a_alignment - 1) & ~(a_alignment - 1);
+            }
+
+            // read only view of a whole file
+            class MappedFile {
+            public:
+                MappedFile(const std::string& a_path) {
+                    file = CreateFileW(std::filesystem::path(a_path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+                    if (file == INVALID_HANDLE_VALUE)
+                        return;
+                    LARGE_INTEGER fileSize;
+                    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0)
+                        return;
+                    mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                    if (!mapping)
+                        return;
+                    data = static_cast<const std::uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                    if (data)
+                        size = static_cast<std::uint64_t>(fileSize.QuadPart);
+                }
+                ~MappedFile() {
+                    if (data)
+                        UnmapViewOfFile(data);
+                    if (mapping)
+                        CloseHandle(mapping);
+                    if (file != INVALID_HANDLE_VALUE)
+                        CloseHandle(file);
+                }
+                MappedFile(const MappedFile&) = delete;
+                MappedFile& operator=(const MappedFile&) = delete;
+
+                inline bool IsValid() const { return data != nullptr; }
+                inline std::span<const std::uint8_t> GetData() const { return {data, static_cast<std::size_t>(size)}; }
+
+            private:
+                HANDLE file = INVALID_HANDLE_VALUE;
+                HANDLE mapping = nullptr;
+                const std::uint8_t* data = nullptr;
+                std::uint64_t size = 0;
+            };
+        }
+
+        bool Write(const std::string& a_path, RE::FormID a_actorID, const GeometryData& a_data, const UpdateSet& a_updateSet)
+        {
+            std::string strings;
+            auto AddString = [&](const std::string& str) {
+                const StringRef ref = {strings.size(), str.size()};
+                strings += str;
+                return ref;
+            };
+            std::vector<std::span<const std::uint8_t>> blocks;
+            std::uint64_t blocksSize = 0;
+            auto AddBlock = [&]<typename T>(std::span<const T> block) {
+                const BlockRef ref = {blocksSize, block.size() * sizeof(T)};
+                blocks.emplace_back(reinterpret_cast<const std::uint8_t*>(block.data()), ref.size);
+                blocksSize += AlignUp(ref.size, blockAlignment);
+                return ref;
+            };
+
+            std::vector<GeometryRecord> records;
+            records.reserve(a_data.geometries.size());
+            for (std::uint32_t i = 0; i < a_data.geometries.size(); i++)
+            {
+                const auto& geo = a_data.geometries[i];
+                GeometryRecord record = {};
+                record.index = i;
+                record.name = AddString(geo.objInfo.info.name);
+                std::memcpy(&record.vertexDesc, &geo.objInfo.info.desc, sizeof(record.vertexDesc));
+                record.vertexCount = geo.objInfo.info.vertexCount;
+                record.geometryBlock = AddBlock(geo.objInfo.GetGeometryBlock());
+                record.dynamicBlock1 = AddBlock(geo.objInfo.GetDynamicBlock1());
+                record.dynamicBlock2 = AddBlock(geo.objInfo.GetDynamicBlock2());
+                record.indicesBlock = AddBlock(geo.objInfo.GetIndicesBlock());
+                const auto update = std::find_if(a_updateSet.begin(), a_updateSet.end(), [&](const auto& pair) {
+                    return pair.first == geo.geometry;
+                });
+                if (update != a_updateSet.end())
+                {
+                    record.flags |= recordFlagUpdate;
+                    record.slot = update->second.slot;
+                    record.detailStrength = update->second.detailStrength;
+                    record.textureName = AddString(update->second.textureName);
+                    record.srcTexturePath = AddString(update->second.srcTexturePath);
+                    record.detailTexturePath = AddString(update->second.detailTexturePath);
+                    record.overlayTexturePath = AddString(update->second.overlayTexturePath);
+                    record.maskTexturePath = AddString(update->second.maskTexturePath);
+                }
+                records.push_back(record);
+            }
+            const std::string config = GetConfigText();
+
+            std::array<SectionEntry, sectionTotal> sections = {};
+            const std::array<std::uint64_t, sectionTotal> sectionSizes = {config.size(), strings.size(), records.size() * sizeof(GeometryRecord), blocksSize};
+            std::uint64_t fileSize = AlignUp(sizeof(FileHeader) + sizeof(sections), sectionAlignment);
+            for (std::uint32_t i = 0; i < sectionTotal; i++)
+            {
+                sections[i].type = i;
+                sections[i].offset = fileSize;
+                sections[i].size = sectionSizes[i];
+                fileSize = AlignUp(fileSize + sectionSizes[i], sectionAlignment);
+            }
+            FileHeader header = {};
+            header.magic = magic;
+            header.version = version;
+            header.sectionCount = sectionTotal;
+            header.fileSize = fileSize;
+            header.actorID = a_actorID;
+
+            std::filesystem::path filePath = a_path;
+            std::error_code ec;
+            std::filesystem::create_directories(filePath.parent_path(), ec);
+
+            std::ofstream ofs(filePath, std::ios::binary);
+            if (!ofs) {
+                logger::error("Unable to write {} file", filePath.string());
+                return false;
+            }
+            ofs.exceptions(std::ios::failbit | std::ios::badbit);
+            try {
+                std::uint64_t position = 0;
+                auto Put = [&](const void* src, std::uint64_t size) {
+                    ofs.write(reinterpret_cast<const char*>(src), static_cast<std::streamsize>(size));
+                    position += size;
+                };
+                auto Pad = [&](std::uint64_t to) {
+                    static constexpr std::array<char, sectionAlignment> zeros = {};
+                    while (position < to)
+                        Put(zeros.data(), std::min(to - position, sectionAlignment));
+                };
+                Put(&header, sizeof(header));
+                Put(sections.data(), sizeof(sections));
+
+                Pad(sections[sectionConfig].offset);
+                Put(config.data(), config.size());
+                Pad(sections[sectionStrings].offset);
+                Put(strings.data(), strings.size());
+                Pad(sections[sectionGeometries].offset);
+                Put(records.data(), records.size() * sizeof(GeometryRecord));
+                Pad(sections[sectionBlocks].offset);
+                for (const auto& block : blocks)
+                {
+                    Put(block.data(), block.size());
+                    Pad(AlignUp(position, blockAlignment));
+                }
+                Pad(fileSize);
+                ofs.close();
+            }
+            catch (...) {
+                logger::error("Unable to write {} file", filePath.string());
+                return false;
+            }
+            return true;
+        }
+
+        bool Load(const std::string& a_path, Capture& a_capture)
+        {
+            auto file = std::make_shared<const MappedFile>(a_path);
+            if (!file->IsValid())
+            {
+                logger::error("{} : Unable to open {}", __func__, a_path);
+                return false;
+            }
+
+            FileView view;
+            if (!view.Parse(file->GetData()))
+            {
+                if (view.header && view.header->version != version)
+                    logger::error("{} : Invalid snapshot {} (version {})", __func__, a_path, view.header->version);
+                else
+                    logger::error("{} : Invalid snapshot {}", __func__, a_path);
+                return false;
+            }
+            auto GetString = [&](const StringRef& ref, std::string& out) {
+                std::string_view str;
+                if (!view.GetString(ref, str))
+                    return false;
+                out = str;
+                return true;
+            };
+
+            a_capture.actorID = view.header->actorID;
+            a_capture.data = std::make_shared<GeometryData>();
+            a_capture.updateSet.clear();
+            a_capture.config.assign(reinterpret_cast<const char*>(view.sections[sectionConfig].data()), view.sections[sectionConfig].size());
+            a_capture.geometryIDs = std::make_unique<std::uint8_t[]>(view.records.size());
+            for (const auto& record : view.records)
+            {
+                // the blocks stay in the mapped file, GetGeometryData reads them from there
+                GeometryData::ObjectInfo objInfo;
+                RE::BSGraphics::VertexDesc desc;
+                std::memcpy(&desc, &record.vertexDesc, sizeof(desc));
+                objInfo.info.SetDesc(desc);
+                objInfo.info.vertexCount = record.vertexCount;
+                objInfo.blockSource = file;
+                if (!GetString(record.name, objInfo.info.name)
+                    || !view.GetBlock(record.geometryBlock, objInfo.geometryBlockView)
+                    || !view.GetBlock(record.dynamicBlock1, objInfo.dynamicBlockView1)
+                    || !view.GetBlock(record.dynamicBlock2, objInfo.dynamicBlockView2)
+                    || !view.GetBlock(record.indicesBlock, objInfo.indicesBlockView)
+                    || objInfo.geometryBlockView.size() != (std::size_t)record.vertexCount * desc.GetSize()
+                    || (!objInfo.dynamicBlockView1.empty() && objInfo.dynamicBlockView1.size() != record.vertexCount)
+                    || (!objInfo.dynamicBlockView2.empty() && objInfo.dynamicBlockView2.size() != record.vertexCount))
+                {
+                    logger::error("{} : Invalid geometry record in {}", __func__, a_path);
+                    return false;
+                }
+
+                // the geometries of the capture are gone, each record gets an id of its own that is never dereferenced
+                RE::BSGeometry* geometry = reinterpret_cast<RE::BSGeometry*>(a_capture.geometryIDs.get() + record.index);
+                if (record.flags & recordFlagUpdate)
+                {
+                    UpdateTextureSet newSet;
+                    newSet.slot = record.slot;
+                    newSet.geometryName = objInfo.info.name;
+                    newSet.detailStrength = record.detailStrength;
+                    if (!GetString(record.textureName, newSet.textureName)
+                        || !GetString(record.srcTexturePath, newSet.srcTexturePath)
+                        || !GetString(record.detailTexturePath, newSet.detailTexturePath)
+                        || !GetString(record.overlayTexturePath, newSet.overlayTexturePath)
+                        || !GetString(record.maskTexturePath, newSet.maskTexturePath))
+                    {
+                        logger::error("{} : Invalid geometry record in {}", __func__, a_path);
+                        return false;
+                    }
+                    a_capture.updateSet.push_back(std::make_pair(geometry, std::move(newSet)));
+                }
+                a_capture.data->AddGeometry(geometry, std::move(objInfo));
+            }
+            return true;
+        }
+
+        std::string GetFilePath(RE::FormID a_actorID)
+        {
+            return GetRuntimeSKSEDirectory() + "MuDynamicNormalMap\\Snapshot\\" + GetHexStr(a_actorID) + ".mdnmsnap";
+        }
+
+        std::string GetConfigText()
+        {
+            std::string configPath = GetRuntimeSKSEDirectory();
+            configPath += SKSE::PluginDeclaration::GetSingleton()->GetName().data();
+            configPath += ".ini";
+
+            std::ifstream file(configPath, std::ios::binary);
+            if (!file.is_open())
+            {
+                configPath = lowLetter(configPath);
+                file.open(configPath, std::ios::binary);
+                if (!file.is_open())
+                    return "";
+            }
+            return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#include "SnapshotFormat.h"
+
+namespace Mus {
+    namespace Snapshot {
+        namespace {
+            inline std::span<const std::uint8_t> GetRange(std::span<const std::uint8_t> a_file, std::uint64_t a_offset, std::uint64_t a_size) {
+                if (a_offset > a_file.size() || a_size > a_file.size() - a_offset)
+                    return {};
+                return a_file.subspan(static_cast<std::size_t>(a_offset), static_cast<std::size_t>(a_size));
+            }
+        }
+
+        bool FileView::Parse(std::span<const std::uint8_t> a_file)
+        {
+            *this = {};
+            if (a_file.size() < sizeof(FileHeader))
+                return false;
+            const FileHeader* fileHeader = reinterpret_cast<const FileHeader*>(a_file.data());
+            if (fileHeader->magic != magic)
+                return false;
+            header = fileHeader;
+            if (header->version != version || header->fileSize != a_file.size())
+                return false;
+
+            const std::uint64_t tableSize = std::uint64_t(header->sectionCount) * sizeof(SectionEntry);
+            const auto sectionTable = GetRange(a_file, sizeof(FileHeader), tableSize);
+            if (sectionTable.size() != tableSize)
+                return false;
+            for (std::uint32_t i = 0; i < header->sectionCount; i++)
+            {
+                const SectionEntry* section = reinterpret_cast<const SectionEntry*>(sectionTable.data()) + i;
+                if (section->type >= sectionTotal) // from a newer writer, not needed here
+                    continue;
+                sections[section->type] = GetRange(a_file, section->offset, section->size);
+                if (sections[section->type].size() != section->size)
+                    return false;
+            }
+
+            const auto& geometries = sections[sectionGeometries];
+            if (geometries.size() % sizeof(GeometryRecord) != 0)
+                return false;
+            records = {reinterpret_cast<const GeometryRecord*>(geometries.data()), geometries.size() / sizeof(GeometryRecord)};
+            for (std::size_t i = 0; i < records.size(); i++)
+            {
+                if (records[i].index >= records.size())
+                    return false;
+            }
+            return true;
+        }
+
+        bool FileView::GetString(const StringRef& a_ref, std::string_view& a_out) const
+        {
+            const auto& strings = sections[sectionStrings];
+            if (a_ref.offset > strings.size() || a_ref.size > strings.size() - a_ref.offset)
+                return false;
+            a_out = {reinterpret_cast<const char*>(strings.data() + a_ref.offset), static_cast<std::size_t>(a_ref.size)};
+            return true;
+        }
+    }
+}
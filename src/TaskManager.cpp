@@ -328,7 +328,12 @@ namespace Mus {
         if (auto found = Papyrus::detailStrengthMap.find(id); found != Papyrus::detailStrengthMap.end())
             detailStrength = found->second;
 		auto gender = GetSex(a_actor);
-		GeometryDataPtr newGeometryData = std::make_shared<GeometryData>();
+		std::uint64_t layoutHash = 0;
+		for (const auto& pair : a_srcGeometies)
+		{
+			layoutHash += GeometryData::GetLayoutHash(pair.second);
+		}
+		GeometryDataPtr newGeometryData = GeometryDataPool::GetSingleton().Acquire(id, layoutHash);
 		UpdateSet newUpdateSet;
 		for (auto& pair : a_srcGeometies)
         {
@@ -418,6 +423,15 @@ namespace Mus {
 			}
         }
 
+		if (RE::FormID snapshotID = id; snapshotActorID.compare_exchange_strong(snapshotID, 0))
+		{
+			const std::string filePath = Snapshot::GetFilePath(id);
+			if (Snapshot::Write(filePath, id, *newGeometryData, newUpdateSet))
+				logger::info("Snapshot done : {}", filePath);
+			else
+				logger::error("Failed to write the snapshot : {}", filePath);
+		}
+
 		QUpdateNormalMapImpl(a_actor->formID, actorName, newGeometryData, newUpdateSet);
 		return true;
 	}
@@ -431,9 +445,10 @@ namespace Mus {
             if (Config::GetSingleton().GetFullUpdateTime())
                 PerformanceLog(std::string("QUpdateNormalMapImpl") + "::" + SetHex(a_actorID, false), false, false);
 
-            if (!ObjectNormalMapUpdater::GetSingleton().CreateGeometryResourceData(a_actorID, a_geoData))
+            if (!ObjectNormalMapUpdater::GetSingleton().CreateGeometryResourceData(a_actorID, a_geoData, a_updateSet))
             {
                 logger::error("{:x}::{} : Failed to get geometry data", a_actorID, a_actorName);
+                GeometryDataPool::GetSingleton().Release(a_actorID, std::move(a_geoData));
                 SetIsUpdating(a_actorID, false);
                 return;
             }
@@ -443,6 +458,8 @@ namespace Mus {
                 textures = ObjectNormalMapUpdater::GetSingleton().UpdateObjectNormalMapGPU(a_actorID, a_geoData, a_updateSet);
             else
                 textures = ObjectNormalMapUpdater::GetSingleton().UpdateObjectNormalMap(a_actorID, a_geoData, a_updateSet);
+            logger::debug("{:x}::{} : scratch arena peak {} KB", a_actorID, a_actorName, a_geoData->arena->GetPeakUsage() / 1024);
+            GeometryDataPool::GetSingleton().Release(a_actorID, std::move(a_geoData));
             if (textures.empty())
             {
                 logger::error("{:x}::{} : Failed to update object normalmap", a_actorID, a_actorName);
@@ -593,6 +610,60 @@ namespace Mus {
             currentActorThreads.load()->submitAsync(func);
 	}
 
+	void TaskManager::ReplaySnapshot(const std::string& a_path)
+	{
+        currentActorThreads.load()->submitAsync([this, a_path]() {
+            // the bake runs under a reserved id, so the captured actor keeps its own geometry resource and updates
+            constexpr RE::FormID replayID = ObjectNormalMapUpdater::replayActorID;
+            if (GetIsUpdating(replayID))
+            {
+                logger::warn("{} : Another replay is running", a_path);
+                return;
+            }
+            SetIsUpdating(replayID, true);
+
+            Snapshot::Capture capture;
+            if (!Snapshot::Load(a_path, capture))
+            {
+                SetIsUpdating(replayID, false);
+                return;
+            }
+            if (capture.config != Snapshot::GetConfigText())
+                logger::warn("{} : The config has changed since the snapshot was written", a_path);
+
+            using clock = std::chrono::high_resolution_clock;
+            const auto geometryStart = clock::now();
+            if (!ObjectNormalMapUpdater::GetSingleton().CreateGeometryResourceData(replayID, capture.data, capture.updateSet))
+            {
+                logger::error("{:x} : Failed to get geometry data", capture.actorID);
+                ObjectNormalMapUpdater::GetSingleton().RemoveGeometryResourceData(replayID);
+                SetIsUpdating(replayID, false);
+                return;
+            }
+            const auto bakeStart = clock::now();
+
+            // never hit the normalmap store, the bake has to run every time
+            const std::uint64_t salt = bakeStart.time_since_epoch().count();
+            for (auto& geo : capture.data->geometries)
+            {
+                geo.hash ^= salt;
+            }
+            ObjectNormalMapUpdater::UpdateResult textures;
+            if (Config::GetSingleton().GetGPUEnable())
+                textures = ObjectNormalMapUpdater::GetSingleton().UpdateObjectNormalMapGPU(replayID, capture.data, capture.updateSet);
+            else
+                textures = ObjectNormalMapUpdater::GetSingleton().UpdateObjectNormalMap(replayID, capture.data, capture.updateSet);
+            const auto bakeEnd = clock::now();
+            ObjectNormalMapUpdater::GetSingleton().RemoveGeometryResourceData(replayID);
+            SetIsUpdating(replayID, false);
+
+            using ms = std::chrono::duration<double, std::milli>;
+            logger::info("{:x} : Replay done {} ({} vertices / {} faces / {} textures) => geometry {:.3f}ms, bake {:.3f}ms, scratch arena peak {} KB",
+                         capture.actorID, a_path, capture.data->vertices.size(), capture.data->indices.size() / 3, textures.size(),
+                         ms(bakeStart - geometryStart).count(), ms(bakeEnd - bakeStart).count(), capture.data->arena->GetPeakUsage() / 1024);
+        });
+	}
+
 	std::string TaskManager::GetDetailNormalMapPath(std::string a_normalMapPath)
 	{
 		constexpr std::string_view prefix = "Textures\\";
@@ -979,6 +1050,7 @@ namespace Mus {
                             return EventResult::kContinue;
                         }
                         Mus::Config::GetSingleton().LoadConfig();
+                        TopologyCache::GetSingleton().Clear(); // recorded with the old subdivision settings
                         InitialSetting();
                         isUpdating.clear();
                         ConditionManager::GetSingleton().InitialConditionList();
@@ -1090,6 +1162,40 @@ namespace Mus {
                             logger::info("Failed to print the mesh : {}", filePath);
                             RE::DebugNotification("MDNM : Failed to print the mesh ");
 						}
+                    }
+				}
+				else if (keyCode == 67) //F9
+				{
+                    if (button->IsUp() && isPressedExportHotkey1)
+                    {
+                        if (Config::GetSingleton().GetLogLevel() >= spdlog::level::level_enum::info)
+                            continue;
+
+                        RE::Actor* target = GetHotkeyTarget();
+                        const std::string filePath = Snapshot::GetFilePath(target->formID);
+                        if (!std::filesystem::exists(filePath))
+                        {
+                            logger::info("No snapshot to replay : {}", filePath);
+                            RE::DebugNotification("MDNM : No snapshot to replay");
+                            continue;
+                        }
+                        logger::info("Replay snapshot... : {}", filePath);
+                        RE::DebugNotification("MDNM : Replay snapshot");
+                        ReplaySnapshot(filePath);
+                    }
+				}
+				else if (keyCode == 68) //F10
+				{
+                    if (button->IsUp() && isPressedExportHotkey1)
+                    {
+                        if (Config::GetSingleton().GetLogLevel() >= spdlog::level::level_enum::info)
+                            continue;
+
+                        RE::Actor* target = GetHotkeyTarget();
+                        logger::info("Snapshot on the next update of {:x}...", target->formID);
+                        RE::DebugNotification("MDNM : Snapshot on the next update");
+                        snapshotActorID = target->formID;
+                        QUpdateNormalMap(target);
                     }
 				}
 				else if (keyCode == 88) //F12
@@ -1168,6 +1274,31 @@ namespace Mus {
 		return EventResult::kContinue;
 	}
 
+	RE::Actor* TaskManager::GetHotkeyTarget() const
+	{
+        RE::Actor* target = nullptr;
+        if (auto consoleRef = RE::Console::GetSelectedRef(); consoleRef && Config::GetSingleton().GetUseConsoleRef())
+        {
+            target = skyrim_cast<RE::Actor*>(consoleRef.get());
+        }
+        if (auto crossHair = RE::CrosshairPickData::GetSingleton(); !target && crossHair && crossHair->targetActor)
+        {
+#ifndef ENABLE_SKYRIM_VR
+            target = skyrim_cast<RE::Actor*>(crossHair->targetActor.get().get());
+#else
+            for (std::uint32_t i = 0; i < RE::VRControls::VR_DEVICE::kTotal; i++)
+            {
+                target = skyrim_cast<RE::Actor*>(crossHair->targetActor[i].get().get());
+                if (target)
+                    break;
+            }
+#endif
+        }
+        if (!target)
+            target = RE::PlayerCharacter::GetSingleton();
+        return target;
+	}
+
 	EventResult TaskManager::ProcessEvent(const RE::MenuOpenCloseEvent* evn, RE::BSTEventSource<RE::MenuOpenCloseEvent>*)
 	{
 		if (!evn || !evn->menuName.c_str())
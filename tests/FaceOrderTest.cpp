@@ -0,0 +1,143 @@
+#include "GeometryKernel.h"
+#include "TestSupport.h"
+
+#include <gtest/gtest.h>
+
+using namespace Mus;
+
+namespace {
+    struct Mesh {
+        std::vector<DirectX::XMFLOAT2> uvs;
+        std::vector<std::uint32_t> indices;
+    };
+
+    // random faces over random uvs, sized to hit both the stable_sort fallback and the radix sort
+    Mesh MakeRandomMesh(std::size_t vertexCount, std::size_t faceCount, std::mt19937& rng)
+    {
+        Mesh mesh;
+        std::uniform_real_distribution<float> uvDist(-0.2f, 1.2f);
+        std::uniform_int_distribution<std::uint32_t> vertexDist(0, static_cast<std::uint32_t>(vertexCount - 1));
+        for (std::size_t i = 0; i < vertexCount; i++)
+        {
+            mesh.uvs.push_back({uvDist(rng), uvDist(rng)});
+        }
+        for (std::size_t f = 0; f < faceCount * 3; f++)
+        {
+            mesh.indices.push_back(vertexDist(rng));
+        }
+        return mesh;
+    }
+
+    // order[begin, end) is a permutation of the faces in the range, sorted by key and stable, the rest untouched
+    template <typename KeyFunc>
+    void ExpectFaceOrder(const std::vector<std::uint32_t>& order, std::size_t begin, std::size_t end, std::uint32_t untouched, KeyFunc&& getKey)
+    {
+        std::vector<std::uint8_t> seen(order.size(), 0);
+        for (std::size_t i = 0; i < order.size(); i++)
+        {
+            if (i < begin || i >= end)
+            {
+                ASSERT_EQ(order[i], untouched) << "position " << i;
+                continue;
+            }
+            const std::uint32_t face = order[i];
+            ASSERT_TRUE(face >= begin && face < end) << "position " << i;
+            ASSERT_EQ(seen[face], 0) << "face " << face << " twice";
+            seen[face] = 1;
+            if (i > begin)
+            {
+                const std::uint32_t prevKey = getKey(order[i - 1]);
+                const std::uint32_t key = getKey(face);
+                ASSERT_LE(prevKey, key) << "position " << i;
+                if (prevKey == key)
+                    ASSERT_LT(order[i - 1], face) << "position " << i << " not stable";
+            }
+        }
+    }
+
+    std::uint32_t UVKey(const Mesh& mesh, std::uint32_t f)
+    {
+        const std::uint32_t i0 = mesh.indices[f * 3 + 0], i1 = mesh.indices[f * 3 + 1], i2 = mesh.indices[f * 3 + 2];
+        if (i0 >= mesh.uvs.size() || i1 >= mesh.uvs.size() || i2 >= mesh.uvs.size())
+            return 0;
+        return GeometryKernel::MortonCode((mesh.uvs[i0].x + mesh.uvs[i1].x + mesh.uvs[i2].x) / 3.0f,
+                                          (mesh.uvs[i0].y + mesh.uvs[i1].y + mesh.uvs[i2].y) / 3.0f);
+    }
+    std::uint32_t VertexKey(const Mesh& mesh, std::uint32_t f)
+    {
+        const std::uint32_t i0 = mesh.indices[f * 3 + 0], i1 = mesh.indices[f * 3 + 1], i2 = mesh.indices[f * 3 + 2];
+        if (i0 >= mesh.uvs.size() || i1 >= mesh.uvs.size() || i2 >= mesh.uvs.size())
+            return 0;
+        return std::min({i0, i1, i2});
+    }
+}
+
+TEST(FaceOrderTest, UVOrderSortsByMortonCode)
+{
+    TBB_ThreadPool tp(std::max(1u, std::thread::hardware_concurrency()), 0);
+    std::mt19937 rng(21);
+    for (const std::size_t faceCount : {1, 100, 5000, 40000})
+    {
+        SCOPED_TRACE(::testing::Message() << "faces " << faceCount);
+        Mesh mesh = MakeRandomMesh(faceCount, faceCount, rng);
+        mesh.indices[0] = UINT32_MAX; // out of range goes first
+        // a geometry in the middle of the merged faces, the other ranges are not touched
+        const std::size_t begin = faceCount / 4;
+        const std::size_t end = faceCount - faceCount / 4;
+        std::vector<std::uint32_t> order(faceCount, UINT32_MAX - 1);
+        GeometryKernel::BuildUVOrder(mesh.indices, mesh.uvs, begin, end, order, &tp);
+        ExpectFaceOrder(order, begin, end, UINT32_MAX - 1, [&](std::uint32_t f) { return UVKey(mesh, f); });
+    }
+}
+
+TEST(FaceOrderTest, VertexOrderSortsBySmallestVertex)
+{
+    TBB_ThreadPool tp(std::max(1u, std::thread::hardware_concurrency()), 0);
+    std::mt19937 rng(22);
+    for (const std::size_t faceCount : {1, 100, 5000, 40000})
+    {
+        SCOPED_TRACE(::testing::Message() << "faces " << faceCount);
+        // few vertices, so many faces share a key and the stability shows
+        Mesh mesh = MakeRandomMesh(std::max<std::size_t>(faceCount / 8, 3), faceCount, rng);
+        mesh.indices.back() = UINT32_MAX;
+        std::vector<std::uint32_t> order(faceCount, UINT32_MAX - 1);
+        GeometryKernel::BuildVertexOrder(mesh.indices, mesh.uvs.size(), 0, faceCount, order, &tp);
+        ExpectFaceOrder(order, 0, faceCount, UINT32_MAX - 1, [&](std::uint32_t f) { return VertexKey(mesh, f); });
+    }
+}
+
+TEST(FaceOrderTest, VertexOrderRestoresAGrid)
+{
+    // a row ordered grid with shuffled faces comes back in row order, the order of an exported mesh
+    constexpr std::uint32_t size = 64;
+    std::vector<std::uint32_t> indices;
+    for (std::uint32_t y = 0; y + 1 < size; y++)
+    {
+        for (std::uint32_t x = 0; x + 1 < size; x++)
+        {
+            const std::uint32_t i00 = y * size + x, i10 = i00 + 1, i01 = i00 + size, i11 = i01 + 1;
+            indices.insert(indices.end(), {i00, i01, i10, i10, i01, i11});
+        }
+    }
+    const std::size_t faceCount = indices.size() / 3;
+    std::vector<std::uint32_t> shuffle(faceCount);
+    std::iota(shuffle.begin(), shuffle.end(), 0);
+    std::shuffle(shuffle.begin(), shuffle.end(), std::mt19937(23));
+    std::vector<std::uint32_t> shuffled(indices.size());
+    for (std::size_t f = 0; f < faceCount; f++)
+    {
+        std::memcpy(&shuffled[f * 3], &indices[shuffle[f] * 3], sizeof(std::uint32_t) * 3);
+    }
+
+    TBB_ThreadPool tp(1, 0);
+    std::vector<std::uint32_t> order(faceCount);
+    GeometryKernel::BuildVertexOrder(shuffled, size * size, 0, faceCount, order, &tp);
+    auto smallest = [](const std::vector<std::uint32_t>& faces, std::size_t f) {
+        return std::min({faces[f * 3 + 0], faces[f * 3 + 1], faces[f * 3 + 2]});
+    };
+    for (std::size_t f = 0; f < faceCount; f++)
+    {
+        // the row order is already sorted by the smallest vertex, faces with the same one may swap
+        ASSERT_EQ(smallest(shuffled, order[f]), smallest(indices, f)) << "position " << f;
+    }
+}
@@ -0,0 +1,185 @@
+#include "GeometryKernel.h"
+#include "TestSupport.h"
+
+#include <gtest/gtest.h>
+
+using namespace Mus;
+
+namespace {
+    struct Mesh {
+        std::vector<DirectX::XMFLOAT3> normals;
+        std::vector<std::uint32_t> indices;
+    };
+
+    // uv sphere with the exact normals, the angle between the normals of a triangle is about 2 * pi / segments
+    Mesh MakeSphere(std::uint32_t segments)
+    {
+        Mesh mesh;
+        const std::uint32_t rings = segments / 2;
+        constexpr float pi = 3.14159265358979f;
+        for (std::uint32_t r = 0; r <= rings; r++)
+        {
+            const float phi = pi * static_cast<float>(r) / static_cast<float>(rings);
+            for (std::uint32_t s = 0; s <= segments; s++)
+            {
+                const float theta = 2.0f * pi * static_cast<float>(s) / static_cast<float>(segments);
+                mesh.normals.push_back({std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta)});
+            }
+        }
+        for (std::uint32_t r = 0; r < rings; r++)
+        {
+            for (std::uint32_t s = 0; s < segments; s++)
+            {
+                const std::uint32_t i00 = r * (segments + 1) + s;
+                const std::uint32_t i10 = i00 + 1;
+                const std::uint32_t i01 = i00 + segments + 1;
+                const std::uint32_t i11 = i01 + 1;
+                mesh.indices.insert(mesh.indices.end(), {i00, i01, i10, i10, i01, i11});
+            }
+        }
+        return mesh;
+    }
+
+    // the interpolation of the cpu bake in ObjectNormalMapUpdater
+    DirectX::XMVECTOR BakeSlerp(DirectX::FXMVECTOR v0, DirectX::FXMVECTOR v1, DirectX::FXMVECTOR v2, const DirectX::XMFLOAT3& bary)
+    {
+        const float denomal = (bary.x + bary.y + floatPrecision);
+        return GeometryKernel::SlerpVector(GeometryKernel::SlerpVector(v0, v1, bary.y / denomal), v2, bary.z);
+    }
+
+    // BakeSlerp in double, the reference both float paths are measured against
+    struct Double3 {
+        double x, y, z;
+    };
+    Double3 Slerp(const Double3& a, const Double3& b, double t)
+    {
+        const double dot = std::clamp(a.x * b.x + a.y * b.y + a.z * b.z, -1.0, 1.0);
+        const double cx = a.y * b.z - a.z * b.y, cy = a.z * b.x - a.x * b.z, cz = a.x * b.y - a.y * b.x;
+        const double theta = std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz), dot);
+        if (theta < 1e-12)
+            return a;
+        const double wa = std::sin((1.0 - t) * theta) / std::sin(theta);
+        const double wb = std::sin(t * theta) / std::sin(theta);
+        return {a.x * wa + b.x * wb, a.y * wa + b.y * wb, a.z * wa + b.z * wb};
+    }
+    DirectX::XMVECTOR ReferenceSlerp(const DirectX::XMFLOAT3& v0, const DirectX::XMFLOAT3& v1, const DirectX::XMFLOAT3& v2, const DirectX::XMFLOAT3& bary)
+    {
+        const Double3 a = {v0.x, v0.y, v0.z}, b = {v1.x, v1.y, v1.z}, c = {v2.x, v2.y, v2.z};
+        const double denomal = static_cast<double>(bary.x) + bary.y;
+        const Double3 r = Slerp(denomal > 0.0 ? Slerp(a, b, bary.y / denomal) : a, c, bary.z);
+        return DirectX::XMVectorSet(static_cast<float>(r.x), static_cast<float>(r.y), static_cast<float>(r.z), 0.0f);
+    }
+
+    // atan2 of |a x b| and a . b in double, acos of a float dot can not resolve less than about 0.02 degree
+    float AngleDegree(DirectX::FXMVECTOR a, DirectX::FXMVECTOR b)
+    {
+        DirectX::XMFLOAT3 fa, fb;
+        DirectX::XMStoreFloat3(&fa, a);
+        DirectX::XMStoreFloat3(&fb, b);
+        const double cx = static_cast<double>(fa.y) * fb.z - static_cast<double>(fa.z) * fb.y;
+        const double cy = static_cast<double>(fa.z) * fb.x - static_cast<double>(fa.x) * fb.z;
+        const double cz = static_cast<double>(fa.x) * fb.y - static_cast<double>(fa.y) * fb.x;
+        const double dot = static_cast<double>(fa.x) * fb.x + static_cast<double>(fa.y) * fb.y + static_cast<double>(fa.z) * fb.z;
+        return static_cast<float>(std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz), dot) * 57.29577951308232);
+    }
+
+    struct ErrorStats {
+        float max = 0.0f;
+        double sum = 0.0;
+        std::size_t count = 0;
+        void Add(float error) {
+            max = std::max(max, error);
+            sum += error;
+            count++;
+        }
+        float Mean() const { return count ? static_cast<float>(sum / count) : 0.0f; }
+    };
+
+    // nlerp and the float slerp of the bake against the double slerp at a grid of barycentric points on every triangle
+    void MeasureError(const Mesh& mesh, ErrorStats& nlerpStats, ErrorStats& slerpStats)
+    {
+        constexpr std::uint32_t steps = 8;
+        for (std::size_t f = 0; f + 2 < mesh.indices.size(); f += 3)
+        {
+            const DirectX::XMFLOAT3& f0 = mesh.normals[mesh.indices[f + 0]];
+            const DirectX::XMFLOAT3& f1 = mesh.normals[mesh.indices[f + 1]];
+            const DirectX::XMFLOAT3& f2 = mesh.normals[mesh.indices[f + 2]];
+            const DirectX::XMVECTOR n0 = DirectX::XMLoadFloat3(&f0);
+            const DirectX::XMVECTOR n1 = DirectX::XMLoadFloat3(&f1);
+            const DirectX::XMVECTOR n2 = DirectX::XMLoadFloat3(&f2);
+            for (std::uint32_t i = 0; i <= steps; i++)
+            {
+                for (std::uint32_t j = 0; i + j <= steps; j++)
+                {
+                    const float by = static_cast<float>(i) / steps;
+                    const float bz = static_cast<float>(j) / steps;
+                    const DirectX::XMFLOAT3 bary(1.0f - by - bz, by, bz);
+                    const DirectX::XMVECTOR reference = ReferenceSlerp(f0, f1, f2, bary);
+                    nlerpStats.Add(AngleDegree(GeometryKernel::NlerpVector(n0, n1, n2, bary), reference));
+                    slerpStats.Add(AngleDegree(BakeSlerp(n0, n1, n2, bary), reference));
+                }
+            }
+        }
+    }
+}
+
+TEST(InterpolationTest, NlerpCloseToSlerpOnSpheres)
+{
+    // segments and the allowed max error of nlerp in degree, a step of an 8 bit normal map is about 0.45 degree
+    // the nlerp error shrinks with the square of the angle between the vertex normals
+    // the float slerp of the bake loses precision on nearly parallel normals instead, it is recorded but not checked
+    const std::pair<std::uint32_t, float> cases[] = {{8, 2.0f}, {16, 0.25f}, {32, 0.04f}, {64, 0.005f}, {256, 0.001f}};
+    for (const auto& [segments, maxError] : cases)
+    {
+        ErrorStats nlerpStats, slerpStats;
+        MeasureError(MakeSphere(segments), nlerpStats, slerpStats);
+        const std::string name = "segments" + std::to_string(segments);
+        RecordProperty(name + "_nlerp_max", std::to_string(nlerpStats.max));
+        RecordProperty(name + "_nlerp_mean", std::to_string(nlerpStats.Mean()));
+        RecordProperty(name + "_slerp_max", std::to_string(slerpStats.max));
+        RecordProperty(name + "_slerp_mean", std::to_string(slerpStats.Mean()));
+        EXPECT_LT(nlerpStats.max, maxError) << segments << " segments, mean " << nlerpStats.Mean();
+    }
+}
+
+TEST(InterpolationTest, VertexValuesAreKept)
+{
+    const Mesh mesh = MakeSphere(16);
+    for (std::size_t f = 0; f + 2 < mesh.indices.size(); f += 3)
+    {
+        const DirectX::XMVECTOR n[3] = {
+            DirectX::XMLoadFloat3(&mesh.normals[mesh.indices[f + 0]]),
+            DirectX::XMLoadFloat3(&mesh.normals[mesh.indices[f + 1]]),
+            DirectX::XMLoadFloat3(&mesh.normals[mesh.indices[f + 2]]),
+        };
+        const DirectX::XMFLOAT3 corners[3] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+        for (std::uint32_t c = 0; c < 3; c++)
+        {
+            // the rsqrt estimate only changes the length, not the direction
+            EXPECT_LT(AngleDegree(GeometryKernel::NlerpVector(n[0], n[1], n[2], corners[c]), n[c]), 0.01f);
+        }
+    }
+}
+
+TEST(InterpolationTest, NlerpIsSymmetric)
+{
+    // the same point with the vertices rotated gives the same normal, slerp only holds this approximately
+    const Mesh mesh = MakeSphere(16);
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    for (std::size_t f = 0; f + 2 < mesh.indices.size(); f += 3)
+    {
+        const DirectX::XMVECTOR n0 = DirectX::XMLoadFloat3(&mesh.normals[mesh.indices[f + 0]]);
+        const DirectX::XMVECTOR n1 = DirectX::XMLoadFloat3(&mesh.normals[mesh.indices[f + 1]]);
+        const DirectX::XMVECTOR n2 = DirectX::XMLoadFloat3(&mesh.normals[mesh.indices[f + 2]]);
+        float u = dist(rng), v = dist(rng);
+        if (u + v > 1.0f)
+        {
+            u = 1.0f - u;
+            v = 1.0f - v;
+        }
+        const DirectX::XMFLOAT3 bary(1.0f - u - v, u, v);
+        const DirectX::XMFLOAT3 rotated(bary.y, bary.z, bary.x);
+        EXPECT_LT(AngleDegree(GeometryKernel::NlerpVector(n0, n1, n2, bary), GeometryKernel::NlerpVector(n1, n2, n0, rotated)), 0.01f);
+    }
+}
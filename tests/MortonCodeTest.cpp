@@ -0,0 +1,70 @@
+#include "GeometryKernel.h"
+#include "TestSupport.h"
+
+#include <gtest/gtest.h>
+
+using namespace Mus;
+
+namespace {
+    // bit by bit interleave, u on the even bits
+    std::uint32_t ReferenceMortonCode(std::uint32_t x, std::uint32_t y)
+    {
+        std::uint32_t code = 0;
+        for (std::uint32_t bit = 0; bit < 16; bit++)
+        {
+            code |= ((x >> bit) & 1) << (bit * 2);
+            code |= ((y >> bit) & 1) << (bit * 2 + 1);
+        }
+        return code;
+    }
+}
+
+TEST(MortonCodeTest, InterleavesQuantizedUV)
+{
+    std::mt19937 rng(13);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    for (std::uint32_t i = 0; i < 10000; i++)
+    {
+        const float u = dist(rng);
+        const float v = dist(rng);
+        const auto x = static_cast<std::uint32_t>(u * 65535.0f);
+        const auto y = static_cast<std::uint32_t>(v * 65535.0f);
+        ASSERT_EQ(GeometryKernel::MortonCode(u, v), ReferenceMortonCode(x, y)) << u << ", " << v;
+    }
+    EXPECT_EQ(GeometryKernel::MortonCode(0.0f, 0.0f), 0u);
+    EXPECT_EQ(GeometryKernel::MortonCode(1.0f, 1.0f), 0xFFFFFFFFu);
+    EXPECT_EQ(GeometryKernel::MortonCode(1.0f, 0.0f), 0x55555555u);
+    EXPECT_EQ(GeometryKernel::MortonCode(0.0f, 1.0f), 0xAAAAAAAAu);
+}
+
+TEST(MortonCodeTest, ClampsOutOfRange)
+{
+    EXPECT_EQ(GeometryKernel::MortonCode(-0.5f, 2.0f), GeometryKernel::MortonCode(0.0f, 1.0f));
+    EXPECT_EQ(GeometryKernel::MortonCode(std::numeric_limits<float>::quiet_NaN(), 0.5f), GeometryKernel::MortonCode(0.0f, 0.5f));
+    EXPECT_EQ(GeometryKernel::MortonCode(std::numeric_limits<float>::infinity(), 0.5f), GeometryKernel::MortonCode(1.0f, 0.5f));
+}
+
+TEST(MortonCodeTest, SortedCodesStayLocal)
+{
+    // a 256 x 256 grid sorted by code walks it in 8 x 8 tiles, every aligned run of 64 codes is one tile
+    constexpr std::uint32_t size = 256;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> cells; // code, cell
+    for (std::uint32_t y = 0; y < size; y++)
+    {
+        for (std::uint32_t x = 0; x < size; x++)
+        {
+            cells.push_back({GeometryKernel::MortonCode((x + 0.5f) / size, (y + 0.5f) / size), y * size + x});
+        }
+    }
+    std::sort(cells.begin(), cells.end());
+    for (std::size_t i = 0; i < cells.size(); i += 64)
+    {
+        const std::uint32_t tileX = (cells[i].second % size) / 8;
+        const std::uint32_t tileY = (cells[i].second / size) / 8;
+        for (std::size_t k = i; k < i + 64; k++)
+        {
+            ASSERT_EQ((cells[k].second % size) / 8, tileX) << "cell " << k;
+            ASSERT_EQ((cells[k].second / size) / 8, tileY) << "cell " << k;
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+// the part of include/PCH.h the portable kernels use, without SKSE, D3D11 and the windows headers
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <immintrin.h>
+
+#include <DirectXMath.h>
+#include <DirectXPackedVector.h>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_scan.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/task_arena.h>
+
+namespace Mus {
+    // Config.h, the tests pick the kernel path with SetSIMDType
+    enum SIMDType {
+        noSIMD,
+        sse2,
+        sse4,
+        avx,
+        avx2,
+        total
+    };
+    SIMDType GetSIMDType(bool scan = false);
+    void SetSIMDType(SIMDType a_type);
+
+    // Store.h
+    constexpr float floatPrecision = 1e-6f;
+
+    // ThreadPool.h without the core masking
+    class TBB_ThreadPool
+    {
+    public:
+        TBB_ThreadPool() = delete;
+        TBB_ThreadPool(std::uint32_t a_threadSize, std::uint64_t)
+            : workers(std::make_unique<tbb::task_arena>(a_threadSize)) {}
+
+        template <typename F>
+        void Execute(F&& f) {
+            workers->execute(std::forward<F>(f));
+        }
+
+        std::int32_t GetThreadSize() const { return workers->max_concurrency(); }
+    private:
+        std::unique_ptr<tbb::task_arena> workers;
+    };
+}
@@ -0,0 +1,80 @@
+#include "GeometryKernel.h"
+#include "TestSupport.h"
+
+#include <gtest/gtest.h>
+
+using namespace Mus;
+
+namespace {
+    // the shape of PosEntry and the face keys, a 64-bit key and a 32-bit payload
+    struct Entry {
+        std::uint64_t key;
+        std::uint32_t payload;
+    };
+
+    std::vector<Entry> MakeEntries(std::size_t count, std::uint64_t keyMask, std::mt19937_64& rng)
+    {
+        std::vector<Entry> entries(count);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            entries[i] = {rng() & keyMask, static_cast<std::uint32_t>(i)};
+        }
+        return entries;
+    }
+
+    void ExpectStableSorted(std::vector<Entry> entries, TBB_ThreadPool* tp)
+    {
+        std::vector<Entry> expected = entries;
+        std::stable_sort(expected.begin(), expected.end(), [](const Entry& a, const Entry& b) { return a.key < b.key; });
+        parallel_radix_sort(entries, [](const Entry& e) { return e.key; }, tp);
+        ASSERT_EQ(entries.size(), expected.size());
+        for (std::size_t i = 0; i < entries.size(); i++)
+        {
+            ASSERT_EQ(entries[i].key, expected[i].key) << "entry " << i;
+            ASSERT_EQ(entries[i].payload, expected[i].payload) << "entry " << i;
+        }
+    }
+}
+
+TEST(RadixSortTest, MatchesStableSort)
+{
+    TBB_ThreadPool tp(std::max(1u, std::thread::hardware_concurrency()), 0);
+    std::mt19937_64 rng(5);
+    // below 4096 falls back to std::stable_sort, above it every block count and tail is hit
+    for (const std::size_t count : {0, 1, 100, 4095, 4096, 4097, 10000, 65537, 300000})
+    {
+        SCOPED_TRACE(::testing::Message() << "count " << count);
+        ExpectStableSorted(MakeEntries(count, ~0ull, rng), &tp);
+    }
+}
+
+TEST(RadixSortTest, SkipsConstantDigits)
+{
+    TBB_ThreadPool tp(std::max(1u, std::thread::hardware_concurrency()), 0);
+    std::mt19937_64 rng(6);
+    // few distinct keys keep stability visible, the masks leave whole 11 bit digits constant
+    for (const std::uint64_t mask : {0ull, 0x7ull, 0xFFFFull, 0xFFFF00000000ull, 0x8000000000000001ull, 0xFF00000000000000ull})
+    {
+        SCOPED_TRACE(::testing::Message() << "mask " << std::hex << mask);
+        ExpectStableSorted(MakeEntries(50000, mask, rng), &tp);
+    }
+}
+
+TEST(RadixSortTest, PresortedAndReversed)
+{
+    TBB_ThreadPool tp(std::max(1u, std::thread::hardware_concurrency()), 0);
+    std::vector<Entry> entries(70000);
+    for (std::size_t i = 0; i < entries.size(); i++)
+    {
+        entries[i] = {static_cast<std::uint64_t>(i) << 20, static_cast<std::uint32_t>(i)};
+    }
+    ExpectStableSorted(entries, &tp);
+    std::reverse(entries.begin(), entries.end());
+    ExpectStableSorted(entries, &tp);
+}
+
+TEST(RadixSortTest, NoThreadPool)
+{
+    std::mt19937_64 rng(7);
+    ExpectStableSorted(MakeEntries(20000, ~0ull, rng), nullptr);
+}
@@ -0,0 +1,192 @@
+#include "GeometryKernel.h"
+#include "TestSupport.h"
+
+#include <gtest/gtest.h>
+
+using namespace Mus;
+
+namespace {
+    struct Triangle {
+        DirectX::XMINT2 a, b, c;
+    };
+    struct Rect {
+        std::int32_t minX, minY, maxX, maxY;
+    };
+
+    // the bounding box of the bake, max exclusive and clamped to the texture
+    Rect Bounds(const Triangle& tri, std::int32_t size)
+    {
+        return {
+            std::clamp(std::min({tri.a.x, tri.b.x, tri.c.x}), 0, size),
+            std::clamp(std::min({tri.a.y, tri.b.y, tri.c.y}), 0, size),
+            std::clamp(std::max({tri.a.x, tri.b.x, tri.c.x}) + 1, 0, size),
+            std::clamp(std::max({tri.a.y, tri.b.y, tri.c.y}) + 1, 0, size),
+        };
+    }
+
+    // the spans as pixels in reference order, checks the span layout on the way
+    std::vector<TestSupport::ReferencePixel> ToPixels(const std::vector<GeometryKernel::RasterSpan>& spans, const Rect& rect)
+    {
+        std::vector<TestSupport::ReferencePixel> pixels;
+        for (const auto& span : spans)
+        {
+            EXPECT_EQ(span.x % static_cast<std::int32_t>(GeometryKernel::laneWidth), 0);
+            EXPECT_NE(span.mask, 0u);
+            EXPECT_EQ(span.mask >> GeometryKernel::laneWidth, 0u);
+            for (std::uint32_t i = 0; i < GeometryKernel::laneWidth; i++)
+            {
+                if ((span.mask & (1u << i)) == 0)
+                    continue;
+                const std::int32_t x = span.x + static_cast<std::int32_t>(i);
+                EXPECT_TRUE(x >= rect.minX && x < rect.maxX && span.y >= rect.minY && span.y < rect.maxY)
+                    << "pixel " << x << ", " << span.y << " outside of the rect";
+                pixels.push_back({x, span.y, span.u[i], span.v[i], span.w[i]});
+            }
+        }
+        std::sort(pixels.begin(), pixels.end(), [](const auto& l, const auto& r) {
+            return l.y != r.y ? l.y < r.y : l.x < r.x;
+        });
+        return pixels;
+    }
+
+    void ExpectSameCoverage(const Triangle& tri, const Rect& rect)
+    {
+        std::vector<TestSupport::ReferencePixel> expected;
+        TestSupport::RasterizeReference(tri.a, tri.b, tri.c, rect.minX, rect.minY, rect.maxX, rect.maxY, expected);
+
+        std::vector<GeometryKernel::RasterSpan> firstSpans;
+        for (const SIMDType path : TestSupport::GetKernelPaths())
+        {
+            SCOPED_TRACE(TestSupport::GetName(path));
+            TestSupport::ScopedSIMDType scoped(path);
+            std::vector<GeometryKernel::RasterSpan> spans;
+            GeometryKernel::RasterizeTriangle(tri.a, tri.b, tri.c, rect.minX, rect.minY, rect.maxX, rect.maxY, spans);
+
+            const auto pixels = ToPixels(spans, rect);
+            ASSERT_EQ(pixels.size(), expected.size());
+            for (std::size_t i = 0; i < pixels.size(); i++)
+            {
+                ASSERT_EQ(pixels[i].x, expected[i].x) << "pixel " << i;
+                ASSERT_EQ(pixels[i].y, expected[i].y) << "pixel " << i;
+                // the edge values are exact, only the 1 / area multiply rounds
+                EXPECT_NEAR(pixels[i].u, expected[i].u, 1e-6) << "pixel " << i;
+                EXPECT_NEAR(pixels[i].v, expected[i].v, 1e-6) << "pixel " << i;
+                EXPECT_NEAR(pixels[i].w, expected[i].w, 1e-6) << "pixel " << i;
+            }
+
+            // both paths do the same float operations, so the spans match bit for bit
+            if (firstSpans.empty())
+            {
+                firstSpans = spans;
+                continue;
+            }
+            ASSERT_EQ(spans.size(), firstSpans.size());
+            for (std::size_t i = 0; i < spans.size(); i++)
+            {
+                ASSERT_EQ(spans[i].x, firstSpans[i].x);
+                ASSERT_EQ(spans[i].y, firstSpans[i].y);
+                ASSERT_EQ(spans[i].mask, firstSpans[i].mask);
+                for (std::uint32_t l = 0; l < GeometryKernel::laneWidth; l++)
+                {
+                    if ((spans[i].mask & (1u << l)) == 0)
+                        continue;
+                    ASSERT_EQ(spans[i].u[l], firstSpans[i].u[l]);
+                    ASSERT_EQ(spans[i].v[l], firstSpans[i].v[l]);
+                    ASSERT_EQ(spans[i].w[l], firstSpans[i].w[l]);
+                }
+            }
+        }
+    }
+
+    // a -> c -> b covers the same pixels, the weights of b and c swap
+    void ExpectBothWindings(const Triangle& tri, const Rect& rect)
+    {
+        ExpectSameCoverage(tri, rect);
+        ExpectSameCoverage({tri.a, tri.c, tri.b}, rect);
+    }
+}
+
+TEST(RasterizeTest, RandomTriangles)
+{
+    constexpr std::int32_t size = 256;
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<std::int32_t> coord(-16, size + 16);
+    for (std::uint32_t i = 0; i < 500; i++)
+    {
+        const Triangle tri = {{coord(rng), coord(rng)}, {coord(rng), coord(rng)}, {coord(rng), coord(rng)}};
+        SCOPED_TRACE(::testing::Message() << "triangle " << i);
+        ExpectBothWindings(tri, Bounds(tri, size));
+    }
+}
+
+TEST(RasterizeTest, SmallTriangles)
+{
+    // the bake mostly sees triangles of a few texels, where the block rejection and the pixel test meet
+    constexpr std::int32_t size = 64;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<std::int32_t> origin(0, size - 1);
+    std::uniform_int_distribution<std::int32_t> offset(-4, 4);
+    for (std::uint32_t i = 0; i < 2000; i++)
+    {
+        const DirectX::XMINT2 a = {origin(rng), origin(rng)};
+        const Triangle tri = {a, {a.x + offset(rng), a.y + offset(rng)}, {a.x + offset(rng), a.y + offset(rng)}};
+        SCOPED_TRACE(::testing::Message() << "triangle " << i);
+        ExpectBothWindings(tri, Bounds(tri, size));
+    }
+}
+
+TEST(RasterizeTest, SliverTriangles)
+{
+    // long and one texel or less wide, every edge passes through many partially covered blocks
+    constexpr std::int32_t size = 4096;
+    std::mt19937 rng(99);
+    std::uniform_int_distribution<std::int32_t> coord(0, size - 1);
+    std::uniform_int_distribution<std::int32_t> thin(-1, 1);
+    for (std::uint32_t i = 0; i < 100; i++)
+    {
+        const DirectX::XMINT2 a = {coord(rng), coord(rng)};
+        const DirectX::XMINT2 b = {coord(rng), coord(rng)};
+        const DirectX::XMINT2 c = {b.x + thin(rng), b.y + thin(rng)};
+        const Triangle tri = {a, b, c};
+        SCOPED_TRACE(::testing::Message() << "triangle " << i);
+        ExpectBothWindings(tri, Bounds(tri, size));
+    }
+    // axis aligned slivers lie exactly on pixel rows and columns
+    ExpectBothWindings({{0, 0}, {4095, 0}, {0, 1}}, {0, 0, size, size});
+    ExpectBothWindings({{3, 0}, {4, 4095}, {3, 4095}}, {0, 0, size, size});
+    ExpectBothWindings({{0, 0}, {4095, 4094}, {4095, 4095}}, {0, 0, size, size});
+}
+
+TEST(RasterizeTest, ClippedRects)
+{
+    // rects that do not start or end on a block, like the tiles of the bake
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<std::int32_t> coord(0, 128);
+    for (std::uint32_t i = 0; i < 300; i++)
+    {
+        const Triangle tri = {{coord(rng), coord(rng)}, {coord(rng), coord(rng)}, {coord(rng), coord(rng)}};
+        std::int32_t x0 = coord(rng), x1 = coord(rng), y0 = coord(rng), y1 = coord(rng);
+        if (x0 > x1)
+            std::swap(x0, x1);
+        if (y0 > y1)
+            std::swap(y0, y1);
+        SCOPED_TRACE(::testing::Message() << "triangle " << i);
+        ExpectBothWindings(tri, {x0, y0, x1, y1});
+    }
+}
+
+TEST(RasterizeTest, DegeneratedTriangles)
+{
+    std::vector<GeometryKernel::RasterSpan> spans(1);
+    for (const SIMDType path : TestSupport::GetKernelPaths())
+    {
+        SCOPED_TRACE(TestSupport::GetName(path));
+        TestSupport::ScopedSIMDType scoped(path);
+        GeometryKernel::RasterizeTriangle({0, 0}, {10, 10}, {20, 20}, 0, 0, 32, 32, spans);
+        EXPECT_TRUE(spans.empty());
+        GeometryKernel::RasterizeTriangle({5, 5}, {5, 5}, {5, 5}, 0, 0, 32, 32, spans);
+        EXPECT_TRUE(spans.empty());
+        GeometryKernel::RasterizeTriangle({0, 0}, {20, 0}, {0, 20}, 10, 10, 10, 20, spans);
+        EXPECT_TRUE(spans.empty());
+    }
+}
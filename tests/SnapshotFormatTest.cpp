@@ -0,0 +1,154 @@
+#include "GeometryKernel.h"
+#include "SnapshotFormat.h"
+
+#include <gtest/gtest.h>
+
+using namespace Mus;
+
+namespace {
+    std::uint64_t AlignUp(std::uint64_t a_value, std::uint64_t a_alignment)
+    {
+        return (a_value + a_alignment - 1) & ~(a_alignment - 1);
+    }
+
+    // the layout Snapshot::Write puts out, two geometries with a triangle each, the second in the update set
+    struct SnapshotFile {
+        std::vector<Snapshot::GeometryRecord> records;
+        std::string strings = "body\nhands\ntextures\\body_msn.dds";
+        std::vector<std::uint8_t> blocks;
+        std::string config = "[Debug]\nlogLevel=2\n";
+
+        SnapshotFile() {
+            for (std::uint32_t i = 0; i < 2; i++)
+            {
+                Snapshot::GeometryRecord record = {};
+                record.index = i;
+                record.name = i == 0 ? Snapshot::StringRef{0, 4} : Snapshot::StringRef{5, 5};
+                record.vertexDesc = (std::uint64_t(1 << 0 | 1 << 1) << 44) | 5; // position and uv, 20 bytes
+                record.vertexCount = 3;
+                record.geometryBlock = AddBlock(std::vector<std::uint8_t>(3 * 20, 0));
+                record.indicesBlock = AddBlock(std::vector<std::uint16_t>{0, 1, 2});
+                if (i == 1)
+                {
+                    record.flags = Snapshot::recordFlagUpdate;
+                    record.srcTexturePath = {11, 21};
+                }
+                records.push_back(record);
+            }
+        }
+
+        template <typename T>
+        Snapshot::BlockRef AddBlock(const std::vector<T>& block) {
+            const Snapshot::BlockRef ref = {blocks.size(), block.size() * sizeof(T)};
+            blocks.resize(AlignUp(blocks.size() + ref.size, Snapshot::blockAlignment));
+            std::memcpy(blocks.data() + ref.offset, block.data(), ref.size);
+            return ref;
+        }
+
+        // aligned like a mapped file, so the records and blocks can be read in place
+        std::vector<std::uint8_t, AlignedAllocator<std::uint8_t, Snapshot::sectionAlignment>> Build() const {
+            std::array<Snapshot::SectionEntry, Snapshot::sectionTotal> sections = {};
+            const std::array<std::uint64_t, Snapshot::sectionTotal> sizes = {config.size(), strings.size(), records.size() * sizeof(Snapshot::GeometryRecord), blocks.size()};
+            const void* sources[Snapshot::sectionTotal] = {config.data(), strings.data(), records.data(), blocks.data()};
+            std::uint64_t fileSize = AlignUp(sizeof(Snapshot::FileHeader) + sizeof(sections), Snapshot::sectionAlignment);
+            for (std::uint32_t i = 0; i < Snapshot::sectionTotal; i++)
+            {
+                sections[i] = {i, 0, fileSize, sizes[i]};
+                fileSize = AlignUp(fileSize + sizes[i], Snapshot::sectionAlignment);
+            }
+            const Snapshot::FileHeader header = {Snapshot::magic, Snapshot::version, Snapshot::sectionTotal, fileSize, 0x14, 0};
+
+            std::vector<std::uint8_t, AlignedAllocator<std::uint8_t, Snapshot::sectionAlignment>> file(fileSize, 0);
+            std::memcpy(file.data(), &header, sizeof(header));
+            std::memcpy(file.data() + sizeof(header), sections.data(), sizeof(sections));
+            for (std::uint32_t i = 0; i < Snapshot::sectionTotal; i++)
+            {
+                std::memcpy(file.data() + sections[i].offset, sources[i], sizes[i]);
+            }
+            return file;
+        }
+    };
+
+    Snapshot::FileHeader& GetHeader(std::span<std::uint8_t> file)
+    {
+        return *reinterpret_cast<Snapshot::FileHeader*>(file.data());
+    }
+    Snapshot::SectionEntry& GetSection(std::span<std::uint8_t> file, Snapshot::SectionType type)
+    {
+        return reinterpret_cast<Snapshot::SectionEntry*>(file.data() + sizeof(Snapshot::FileHeader))[type];
+    }
+}
+
+TEST(SnapshotFormatTest, ReadsInPlace)
+{
+    const SnapshotFile source;
+    const auto file = source.Build();
+    Snapshot::FileView view;
+    ASSERT_TRUE(view.Parse(file));
+    EXPECT_EQ(view.header->actorID, 0x14u);
+    EXPECT_EQ(std::string_view(reinterpret_cast<const char*>(view.sections[Snapshot::sectionConfig].data()), view.sections[Snapshot::sectionConfig].size()), source.config);
+    ASSERT_EQ(view.records.size(), 2u);
+    EXPECT_EQ(reinterpret_cast<const std::uint8_t*>(view.records.data()), file.data() + Snapshot::sectionAlignment * 3);
+
+    std::string_view name, texture;
+    ASSERT_TRUE(view.GetString(view.records[1].name, name));
+    ASSERT_TRUE(view.GetString(view.records[1].srcTexturePath, texture));
+    EXPECT_EQ(name, "hands");
+    EXPECT_EQ(texture, "textures\\body_msn.dds");
+
+    std::span<const std::uint16_t> indices;
+    ASSERT_TRUE(view.GetBlock(view.records[1].indicesBlock, indices));
+    EXPECT_EQ(std::vector<std::uint16_t>(indices.begin(), indices.end()), (std::vector<std::uint16_t>{0, 1, 2}));
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(indices.data()) % Snapshot::blockAlignment, 0u);
+    EXPECT_GE(reinterpret_cast<const std::uint8_t*>(indices.data()), view.sections[Snapshot::sectionBlocks].data());
+}
+
+TEST(SnapshotFormatTest, KeepsTheHeaderOfAnotherVersion)
+{
+    auto file = SnapshotFile().Build();
+    GetHeader(file).version = 1;
+    Snapshot::FileView view;
+    EXPECT_FALSE(view.Parse(file));
+    ASSERT_NE(view.header, nullptr);
+    EXPECT_EQ(view.header->version, 1u);
+
+    GetHeader(file).magic = 0;
+    EXPECT_FALSE(view.Parse(file));
+    EXPECT_EQ(view.header, nullptr);
+}
+
+TEST(SnapshotFormatTest, RejectsRangesOutsideTheFile)
+{
+    const auto source = SnapshotFile().Build();
+    Snapshot::FileView view;
+    EXPECT_FALSE(view.Parse(std::span(source).first(source.size() - 1))) << "truncated";
+    EXPECT_FALSE(view.Parse(std::span(source).first(sizeof(Snapshot::FileHeader) - 1))) << "no header";
+
+    auto file = source;
+    GetSection(file, Snapshot::sectionBlocks).size = file.size();
+    EXPECT_FALSE(view.Parse(file)) << "section past the end";
+
+    file = source;
+    GetHeader(file).sectionCount = 1u << 30;
+    EXPECT_FALSE(view.Parse(file)) << "section table past the end";
+
+    file = source;
+    GetSection(file, Snapshot::sectionGeometries).size -= 8;
+    EXPECT_FALSE(view.Parse(file)) << "partial record";
+
+    file = source;
+    reinterpret_cast<Snapshot::GeometryRecord*>(file.data() + GetSection(file, Snapshot::sectionGeometries).offset)[1].index = 2;
+    EXPECT_FALSE(view.Parse(file)) << "index past the records";
+
+    file = source;
+    GetSection(file, Snapshot::sectionBlocks).type = Snapshot::sectionTotal; // a section of a newer writer is skipped
+    ASSERT_TRUE(view.Parse(file));
+    std::span<const std::uint16_t> indices;
+    EXPECT_FALSE(view.GetBlock(view.records[0].indicesBlock, indices));
+
+    ASSERT_TRUE(view.Parse(source));
+    std::span<const std::uint32_t> wrongType;
+    EXPECT_FALSE(view.GetBlock(view.records[0].indicesBlock, wrongType)) << "6 bytes as uint32";
+    std::string_view str;
+    EXPECT_FALSE(view.GetString({source.size(), 1}, str));
+}
@@ -0,0 +1,101 @@
+#include "TestSupport.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Mus {
+    namespace {
+        SIMDType DetectSIMDType()
+        {
+#ifdef _MSC_VER
+            int info[4] = {};
+            __cpuid(info, 0);
+            if (info[0] >= 7)
+            {
+                __cpuidex(info, 7, 0);
+                if ((info[1] & (1 << 5)) != 0)
+                    return SIMDType::avx2;
+            }
+            return SIMDType::sse4;
+#else
+            return __builtin_cpu_supports("avx2") ? SIMDType::avx2 : SIMDType::sse4;
+#endif
+        }
+        SIMDType currentSIMDType = DetectSIMDType();
+    }
+
+    SIMDType GetSIMDType(bool scan)
+    {
+        if (scan)
+            currentSIMDType = DetectSIMDType();
+        return currentSIMDType;
+    }
+    void SetSIMDType(SIMDType a_type)
+    {
+        currentSIMDType = a_type;
+    }
+
+    namespace TestSupport {
+        bool HasAVX2()
+        {
+            return DetectSIMDType() == SIMDType::avx2;
+        }
+
+        std::vector<SIMDType> GetKernelPaths()
+        {
+            if (HasAVX2())
+                return {SIMDType::sse4, SIMDType::avx2};
+            return {SIMDType::sse4};
+        }
+
+        const char* GetName(SIMDType a_type)
+        {
+            switch (a_type)
+            {
+            case SIMDType::sse2:
+                return "sse2";
+            case SIMDType::sse4:
+                return "sse4";
+            case SIMDType::avx:
+                return "avx";
+            case SIMDType::avx2:
+                return "avx2";
+            default:
+                return "noSIMD";
+            }
+        }
+
+        void RasterizeReference(const DirectX::XMINT2& a, const DirectX::XMINT2& b, const DirectX::XMINT2& c,
+                                std::int32_t minX, std::int32_t minY, std::int32_t maxX, std::int32_t maxY,
+                                std::vector<ReferencePixel>& pixels)
+        {
+            pixels.clear();
+            const std::int64_t area = (static_cast<std::int64_t>(b.x) - a.x) * (static_cast<std::int64_t>(c.y) - a.y)
+                - (static_cast<std::int64_t>(b.y) - a.y) * (static_cast<std::int64_t>(c.x) - a.x);
+            if (area == 0)
+                return;
+            const std::int64_t sign = area < 0 ? -1 : 1;
+
+            // doubled edge function at the pixel center (x + 0.5, y + 0.5), >= 0 on the inner side of from -> to
+            auto edge = [sign](const DirectX::XMINT2& from, const DirectX::XMINT2& to, std::int64_t x, std::int64_t y) {
+                const std::int64_t ex = static_cast<std::int64_t>(to.x) - from.x;
+                const std::int64_t ey = static_cast<std::int64_t>(to.y) - from.y;
+                return sign * (ex * (2 * y + 1 - 2 * from.y) - ey * (2 * x + 1 - 2 * from.x));
+            };
+            const double doubledArea = 2.0 * static_cast<double>(area * sign);
+            for (std::int32_t y = minY; y < maxY; y++)
+            {
+                for (std::int32_t x = minX; x < maxX; x++)
+                {
+                    const std::int64_t eu = edge(b, c, x, y);
+                    const std::int64_t ev = edge(c, a, x, y);
+                    const std::int64_t ew = edge(a, b, x, y);
+                    if (eu < 0 || ev < 0 || ew < 0)
+                        continue;
+                    pixels.push_back({x, y, eu / doubledArea, ev / doubledArea, ew / doubledArea});
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+namespace Mus {
+    namespace TestSupport {
+        bool HasAVX2();
+
+        // runs the kernels on one path until the end of the scope
+        class ScopedSIMDType {
+        public:
+            ScopedSIMDType(SIMDType a_type) : old(GetSIMDType()) { SetSIMDType(a_type); }
+            ~ScopedSIMDType() { SetSIMDType(old); }
+            ScopedSIMDType(const ScopedSIMDType&) = delete;
+            ScopedSIMDType& operator=(const ScopedSIMDType&) = delete;
+
+        private:
+            const SIMDType old;
+        };
+
+        // the paths a kernel has, avx2 only on a cpu with it
+        std::vector<SIMDType> GetKernelPaths();
+        const char* GetName(SIMDType a_type);
+
+        // RasterizeTriangle one pixel at a time with exact integer edge functions, rows then columns
+        struct ReferencePixel {
+            std::int32_t x, y;
+            double u, v, w;
+        };
+        void RasterizeReference(const DirectX::XMINT2& a, const DirectX::XMINT2& b, const DirectX::XMINT2& c,
+                                std::int32_t minX, std::int32_t minY, std::int32_t maxX, std::int32_t maxY,
+                                std::vector<ReferencePixel>& pixels);
+    }
+}
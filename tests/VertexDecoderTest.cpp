@@ -0,0 +1,151 @@
+#include "GeometryKernel.h"
+#include "TestSupport.h"
+
+#include <gtest/gtest.h>
+
+using namespace Mus;
+
+namespace {
+    // half -> float from the bit layout, independent of DirectXMath and F16C
+    float ReferenceHalfToFloat(std::uint16_t h)
+    {
+        const int sign = (h >> 15) & 1;
+        const int exponent = (h >> 10) & 0x1F;
+        const int mantissa = h & 0x3FF;
+        float value;
+        if (exponent == 0)
+            value = std::ldexp(static_cast<float>(mantissa), -24);
+        else
+            value = std::ldexp(static_cast<float>(mantissa | 0x400), exponent - 25);
+        return sign ? -value : value;
+    }
+
+    // finite halves only, inf and nan have no fractional part to compare
+    std::uint16_t RandomHalf(std::mt19937& rng)
+    {
+        std::uniform_int_distribution<std::uint32_t> dist(0, 0xFFFF);
+        std::uint16_t h;
+        do
+        {
+            h = static_cast<std::uint16_t>(dist(rng));
+        } while ((h & 0x7C00) == 0x7C00);
+        return h;
+    }
+
+    struct VertexBlocks {
+        std::vector<std::uint8_t> bytes;
+        std::vector<DirectX::XMFLOAT3> positions;
+        std::vector<DirectX::XMFLOAT2> uvs;
+    };
+
+    // the layout of the skyrim vertex block, position(float3 + 4 bytes) then uv(half2), the rest of the stride is noise
+    VertexBlocks MakeBlocks(std::uint32_t format, std::uint32_t vertexSize, std::size_t count, std::mt19937& rng)
+    {
+        VertexBlocks result;
+        result.bytes.resize(vertexSize * count);
+        result.positions.resize(count);
+        result.uvs.resize(count);
+        std::uniform_int_distribution<std::uint32_t> byteDist(0, 255);
+        std::uniform_real_distribution<float> positionDist(-1000.0f, 1000.0f);
+        for (auto& b : result.bytes)
+            b = static_cast<std::uint8_t>(byteDist(rng));
+        for (std::size_t i = 0; i < count; i++)
+        {
+            std::uint8_t* block = result.bytes.data() + i * vertexSize;
+            if (format & GeometryKernel::vertexFormatPosition)
+            {
+                result.positions[i] = {positionDist(rng), positionDist(rng), positionDist(rng)};
+                std::memcpy(block, &result.positions[i], sizeof(DirectX::XMFLOAT3));
+                block += 16;
+            }
+            if (format & GeometryKernel::vertexFormatUV)
+            {
+                const std::uint16_t half[2] = {RandomHalf(rng), RandomHalf(rng)};
+                std::memcpy(block, half, sizeof(half));
+                const float u = ReferenceHalfToFloat(half[0]);
+                const float v = ReferenceHalfToFloat(half[1]);
+                result.uvs[i] = {u - std::floor(u), v - std::floor(v)};
+            }
+        }
+        return result;
+    }
+
+    std::uint32_t MinVertexSize(std::uint32_t format)
+    {
+        std::uint32_t size = 0;
+        if (format & GeometryKernel::vertexFormatPosition)
+            size += 16;
+        if (format & GeometryKernel::vertexFormatUV)
+            size += 4;
+        return std::max(size, 4u);
+    }
+}
+
+TEST(VertexDecoderTest, MatchesReferenceForEveryFormatAndPath)
+{
+    constexpr DirectX::XMFLOAT3 untouchedPosition = {-7.0f, -7.0f, -7.0f};
+    constexpr DirectX::XMFLOAT2 untouchedUV = {-7.0f, -7.0f};
+    std::mt19937 rng(1234);
+    for (const SIMDType path : TestSupport::GetKernelPaths())
+    {
+        TestSupport::ScopedSIMDType scoped(path);
+        for (std::uint32_t format = 0; format < GeometryKernel::vertexFormatTotal; format++)
+        {
+            const GeometryKernel::VertexDecoder decoder = GeometryKernel::GetVertexDecoder(format);
+            ASSERT_NE(decoder, nullptr);
+            const std::uint32_t minSize = MinVertexSize(format);
+            for (const std::uint32_t vertexSize : {minSize, minSize + 4, 32u, 44u})
+            {
+                if (vertexSize < minSize)
+                    continue;
+                // 8 vertices per avx2 step, so the counts hit no step, only the tail and both
+                for (const std::size_t count : {0, 1, 7, 8, 9, 16, 37, 1000})
+                {
+                    SCOPED_TRACE(::testing::Message() << TestSupport::GetName(path) << " format " << format
+                                                      << " vertexSize " << vertexSize << " count " << count);
+                    const VertexBlocks blocks = MakeBlocks(format, vertexSize, count, rng);
+                    std::vector<DirectX::XMFLOAT3> positions(count, untouchedPosition);
+                    std::vector<DirectX::XMFLOAT2> uvs(count, untouchedUV);
+                    decoder(blocks.bytes.data(), vertexSize, count, positions.data(), uvs.data());
+
+                    for (std::size_t i = 0; i < count; i++)
+                    {
+                        const DirectX::XMFLOAT3 expectedPosition = (format & GeometryKernel::vertexFormatPosition) ? blocks.positions[i] : untouchedPosition;
+                        const DirectX::XMFLOAT2 expectedUV = (format & GeometryKernel::vertexFormatUV) ? blocks.uvs[i] : untouchedUV;
+                        // half -> float is exact, so every path has to match bit for bit
+                        ASSERT_EQ(std::memcmp(&positions[i], &expectedPosition, sizeof(DirectX::XMFLOAT3)), 0) << "vertex " << i;
+                        ASSERT_EQ(uvs[i].x, expectedUV.x) << "vertex " << i;
+                        ASSERT_EQ(uvs[i].y, expectedUV.y) << "vertex " << i;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(VertexDecoderTest, EveryHalfMatchesReference)
+{
+    // all finite halves through the uv decoder, 8 at a time fits the avx2 step exactly
+    constexpr std::uint32_t vertexSize = 4;
+    std::vector<std::uint16_t> halves;
+    for (std::uint32_t h = 0; h <= 0xFFFF; h++)
+    {
+        if ((h & 0x7C00) != 0x7C00)
+            halves.push_back(static_cast<std::uint16_t>(h));
+    }
+    const std::size_t count = halves.size() / 2;
+    for (const SIMDType path : TestSupport::GetKernelPaths())
+    {
+        SCOPED_TRACE(TestSupport::GetName(path));
+        TestSupport::ScopedSIMDType scoped(path);
+        std::vector<DirectX::XMFLOAT2> uvs(count);
+        GeometryKernel::GetVertexDecoder(GeometryKernel::vertexFormatUV)(reinterpret_cast<const std::uint8_t*>(halves.data()), vertexSize, count, nullptr, uvs.data());
+        for (std::size_t i = 0; i < count; i++)
+        {
+            const float u = ReferenceHalfToFloat(halves[i * 2]);
+            const float v = ReferenceHalfToFloat(halves[i * 2 + 1]);
+            ASSERT_EQ(uvs[i].x, u - std::floor(u)) << "half " << halves[i * 2];
+            ASSERT_EQ(uvs[i].y, v - std::floor(v)) << "half " << halves[i * 2 + 1];
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#include "GeometryKernel.h"
+
+#include <gtest/gtest.h>
+
+using namespace Mus;
+
+namespace {
+    // the seam weld of GeometryData::AddWeldBoundaryVertices on the vertices of a test mesh
+    struct Seam {
+        std::vector<DirectX::XMFLOAT3> vertices;
+        std::vector<std::uint16_t> vertexGeometry;
+        GeometryKernel::DisjointSet weldSet;
+
+        std::uint32_t Add(std::uint16_t geometry, DirectX::XMFLOAT3 position) {
+            vertices.push_back(position);
+            vertexGeometry.push_back(geometry);
+            return static_cast<std::uint32_t>(vertices.size() - 1);
+        }
+        void Weld(std::vector<GeometryKernel::WeldPair> pairs) {
+            weldSet.Reset(vertices.size());
+            GeometryKernel::WeldSeamPairs(pairs, vertices, vertexGeometry, weldSet);
+        }
+        bool IsWelded(std::uint32_t v0, std::uint32_t v1) {
+            return weldSet.Find(v0) == weldSet.Find(v1);
+        }
+    };
+}
+
+TEST(WeldSeamTest, NeverWeldsOneGeometryThroughAnother)
+{
+    // two vertices of a under one boundary key, the closer one takes the seam
+    Seam seam;
+    const std::uint32_t a0 = seam.Add(0, {0.0f, 0.0f, 0.0f});
+    const std::uint32_t a1 = seam.Add(0, {0.002f, 0.0f, 0.0f});
+    const std::uint32_t b0 = seam.Add(1, {0.0005f, 0.0f, 0.0f});
+    seam.Weld({{a1, b0}, {a0, b0}});
+    EXPECT_TRUE(seam.IsWelded(a0, b0));
+    EXPECT_FALSE(seam.IsWelded(a1, b0));
+    EXPECT_FALSE(seam.IsWelded(a0, a1));
+}
+
+TEST(WeldSeamTest, KeyChainsDoNotMergeOneGeometry)
+{
+    // a0 - b0 and b0 - a1 come from the low and the high key of b0, a0 and a1 must stay apart
+    Seam seam;
+    const std::uint32_t a0 = seam.Add(0, {0.0f, 0.0f, 0.0f});
+    const std::uint32_t b0 = seam.Add(1, {0.001f, 0.0f, 0.0f});
+    const std::uint32_t a1 = seam.Add(0, {0.003f, 0.0f, 0.0f});
+    const std::uint32_t b1 = seam.Add(1, {0.003f, 0.0f, 0.0f});
+    seam.Weld({{a0, b0}, {b0, a1}, {a1, b1}});
+    EXPECT_TRUE(seam.IsWelded(a0, b0));
+    EXPECT_TRUE(seam.IsWelded(a1, b1));
+    EXPECT_FALSE(seam.IsWelded(a0, a1));
+    EXPECT_FALSE(seam.IsWelded(b0, b1));
+}
+
+TEST(WeldSeamTest, KeepsPositionClusters)
+{
+    // a0 and a1 share a position and are welded before the seam, the seam joins both to b0
+    Seam seam;
+    const std::uint32_t a0 = seam.Add(0, {0.0f, 0.0f, 0.0f});
+    const std::uint32_t a1 = seam.Add(0, {0.0f, 0.0f, 0.0f});
+    const std::uint32_t b0 = seam.Add(1, {0.001f, 0.0f, 0.0f});
+    seam.weldSet.Reset(seam.vertices.size());
+    seam.weldSet.Union(a0, a1);
+    std::vector<GeometryKernel::WeldPair> pairs = {{a1, b0}, {b0, a0}, {a0, b0}};
+    GeometryKernel::WeldSeamPairs(pairs, seam.vertices, seam.vertexGeometry, seam.weldSet);
+    EXPECT_TRUE(seam.IsWelded(a0, b0));
+    EXPECT_TRUE(seam.IsWelded(a1, b0));
+    EXPECT_EQ(pairs.size(), 2u) << "the reversed pair is a duplicate";
+}
+
+TEST(WeldSeamTest, JoinsAJunctionOfThreeGeometries)
+{
+    Seam seam;
+    const std::uint32_t a0 = seam.Add(0, {0.0f, 0.0f, 0.0f});
+    const std::uint32_t b0 = seam.Add(1, {0.0f, 0.001f, 0.0f});
+    const std::uint32_t c0 = seam.Add(2, {0.001f, 0.0f, 0.0f});
+    seam.Weld({{a0, b0}, {a0, c0}, {b0, c0}});
+    EXPECT_TRUE(seam.IsWelded(a0, b0));
+    EXPECT_TRUE(seam.IsWelded(a0, c0));
+}
+
+TEST(WeldSeamTest, VerticesWithoutGeometryAlwaysWeld)
+{
+    Seam seam;
+    const std::uint32_t a0 = seam.Add(0, {0.0f, 0.0f, 0.0f});
+    const std::uint32_t n0 = seam.Add(UINT16_MAX, {0.001f, 0.0f, 0.0f});
+    const std::uint32_t n1 = seam.Add(UINT16_MAX, {0.002f, 0.0f, 0.0f});
+    seam.Weld({{a0, n0}, {a0, n1}});
+    EXPECT_TRUE(seam.IsWelded(a0, n0));
+    EXPECT_TRUE(seam.IsWelded(a0, n1));
+}
@@ -0,0 +1,261 @@
+#include "GeometryKernel.h"
+#include "TestSupport.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace Mus;
+
+namespace {
+    // set associative LRU cache of 64 byte lines, counts the misses of an address stream
+    class CacheModel {
+    public:
+        CacheModel(std::size_t bytes, std::size_t ways)
+            : ways(ways), sets(bytes / 64 / ways), tags(sets * ways, UINT64_MAX), ages(sets * ways, 0) {}
+
+        void Access(const void* address) {
+            const std::uint64_t line = reinterpret_cast<std::uintptr_t>(address) >> 6;
+            const std::size_t set = static_cast<std::size_t>(line % sets);
+            std::uint64_t* setTags = &tags[set * ways];
+            std::uint64_t* setAges = &ages[set * ways];
+            clock++;
+            std::size_t victim = 0;
+            for (std::size_t w = 0; w < ways; w++)
+            {
+                if (setTags[w] == line)
+                {
+                    setAges[w] = clock;
+                    return;
+                }
+                if (setAges[w] < setAges[victim])
+                    victim = w;
+            }
+            misses++;
+            setTags[victim] = line;
+            setAges[victim] = clock;
+        }
+        std::uint64_t misses = 0;
+
+    private:
+        std::size_t ways, sets;
+        std::vector<std::uint64_t> tags, ages;
+        std::uint64_t clock = 0;
+    };
+
+    // the l1 and l2 of the machine the numbers in the commit come from
+    struct CacheHierarchy {
+        CacheModel l1{48 * 1024, 12};
+        CacheModel l2{2 * 1024 * 1024, 16};
+        void Access(const void* address) {
+            const std::uint64_t before = l1.misses;
+            l1.Access(address);
+            if (l1.misses != before)
+                l2.Access(address);
+        }
+    };
+
+    // a grid of size x size vertices like a body part, vertices and faces in row order like an exported mesh
+    // the uv layout cuts the grid into 4 x 4 islands and packs them shuffled, so uv order differs from vertex order
+    struct Mesh {
+        std::vector<DirectX::XMFLOAT3> vertices;
+        std::vector<DirectX::XMFLOAT2> uvs;
+        std::vector<std::uint32_t> indices;
+    };
+    Mesh MakeMesh(std::uint32_t size)
+    {
+        constexpr std::uint32_t islands = 4;
+        Mesh mesh;
+        std::array<std::uint32_t, islands * islands> islandSlot;
+        std::iota(islandSlot.begin(), islandSlot.end(), 0);
+        std::shuffle(islandSlot.begin(), islandSlot.end(), std::mt19937(17));
+        const float islandSize = 1.0f / islands;
+        for (std::uint32_t y = 0; y < size; y++)
+        {
+            for (std::uint32_t x = 0; x < size; x++)
+            {
+                const float fx = static_cast<float>(x) / (size - 1);
+                const float fy = static_cast<float>(y) / (size - 1);
+                mesh.vertices.push_back({fx, fy, std::sin(fx * 6.0f) * std::cos(fy * 4.0f) * 0.1f});
+                const std::uint32_t island = std::min(y * islands / size, islands - 1) * islands + std::min(x * islands / size, islands - 1);
+                const std::uint32_t slot = islandSlot[island];
+                const float localX = fx * islands - std::floor(std::min(fx * islands, islands - 1.0f));
+                const float localY = fy * islands - std::floor(std::min(fy * islands, islands - 1.0f));
+                mesh.uvs.push_back({((slot % islands) + localX * 0.95f) * islandSize, ((slot / islands) + localY * 0.95f) * islandSize});
+            }
+        }
+        for (std::uint32_t y = 0; y + 1 < size; y++)
+        {
+            for (std::uint32_t x = 0; x + 1 < size; x++)
+            {
+                const std::uint32_t i00 = y * size + x, i10 = i00 + 1, i01 = i00 + size, i11 = i01 + 1;
+                mesh.indices.insert(mesh.indices.end(), {i00, i01, i10, i10, i01, i11});
+            }
+        }
+        return mesh;
+    }
+
+    enum Order : std::int64_t {
+        original,
+        uv,
+        vertex,
+        shuffled,
+        shuffledVertex // vertex order of the shuffled faces, what the reorder makes of a badly ordered mesh
+    };
+    const char* GetOrderName(std::int64_t order)
+    {
+        switch (order)
+        {
+        case Order::uv:
+            return "uv morton";
+        case Order::vertex:
+            return "vertex";
+        case Order::shuffled:
+            return "shuffled";
+        case Order::shuffledVertex:
+            return "shuffled + vertex";
+        default:
+            return "original";
+        }
+    }
+
+    std::vector<std::uint32_t> Renumber(const std::vector<std::uint32_t>& indices, const std::vector<std::uint32_t>& faceOrder)
+    {
+        std::vector<std::uint32_t> ordered(indices.size());
+        for (std::size_t f = 0; f < faceOrder.size(); f++)
+        {
+            std::memcpy(&ordered[f * 3], &indices[faceOrder[f] * 3], sizeof(std::uint32_t) * 3);
+        }
+        return ordered;
+    }
+
+    // faces renumbered into the order, the normal passes index faces by their position in indices
+    std::vector<std::uint32_t> Reorder(const Mesh& mesh, std::int64_t order, TBB_ThreadPool* tp)
+    {
+        const std::size_t faceCount = mesh.indices.size() / 3;
+        std::vector<std::uint32_t> faceOrder(faceCount);
+        std::iota(faceOrder.begin(), faceOrder.end(), 0);
+        if (order == Order::uv)
+        {
+            GeometryKernel::BuildUVOrder(mesh.indices, mesh.uvs, 0, faceCount, faceOrder, tp);
+        }
+        else if (order == Order::vertex)
+        {
+            GeometryKernel::BuildVertexOrder(mesh.indices, mesh.vertices.size(), 0, faceCount, faceOrder, tp);
+        }
+        else if (order == Order::shuffled || order == Order::shuffledVertex)
+        {
+            std::shuffle(faceOrder.begin(), faceOrder.end(), std::mt19937(3));
+            if (order == Order::shuffledVertex)
+            {
+                const auto shuffled = Renumber(mesh.indices, faceOrder);
+                GeometryKernel::BuildVertexOrder(shuffled, mesh.vertices.size(), 0, faceCount, faceOrder, tp);
+                return Renumber(shuffled, faceOrder);
+            }
+        }
+        return Renumber(mesh.indices, faceOrder);
+    }
+
+    struct NormalPasses {
+        GeometryKernel::Float3Planes vertexPlanes;
+        GeometryKernel::Float2Planes uvPlanes;
+        GeometryKernel::FacePlanes facePlanes;
+        GeometryKernel::AdjacencyList vertexToFaceMap;
+        GeometryKernel::Float3Planes faceNormals, faceTangents, faceBitangents;
+        std::vector<DirectX::XMFLOAT3> normals;
+
+        NormalPasses(const Mesh& mesh, const std::vector<std::uint32_t>& indices, TBB_ThreadPool* tp) {
+            vertexPlanes.Load(mesh.vertices, tp);
+            uvPlanes.Load(mesh.uvs, tp);
+            facePlanes.Load(indices, mesh.vertices.size(), tp);
+            vertexToFaceMap.Build(mesh.vertices.size(), indices, 3, tp);
+            const std::size_t faceCount = indices.size() / 3;
+            faceNormals.Resize(faceCount);
+            faceTangents.Resize(faceCount);
+            faceBitangents.Resize(faceCount);
+            normals.resize(mesh.vertices.size());
+        }
+
+        // CreateFaceData and the face normal sum of RecalculateNormals, single threaded to keep the access pattern
+        void Run() {
+            GeometryKernel::ComputeFaceData(vertexPlanes, uvPlanes, facePlanes, 0, GeometryKernel::BlockCount(facePlanes.count),
+                                            faceNormals, faceTangents, faceBitangents);
+            for (std::size_t i = 0; i < vertexToFaceMap.size(); i++)
+            {
+                DirectX::XMVECTOR sum = DirectX::XMVectorZero();
+                for (const auto& fi : vertexToFaceMap[i])
+                {
+                    sum = DirectX::XMVectorAdd(sum, faceNormals.Get(fi));
+                }
+                DirectX::XMStoreFloat3(&normals[i], sum);
+            }
+        }
+
+        // the loads and stores of Run in program order
+        void Simulate(CacheHierarchy& cache) const {
+            for (std::size_t block = 0; block < GeometryKernel::BlockCount(facePlanes.count); block++)
+            {
+                const std::size_t base = block * GeometryKernel::laneWidth;
+                cache.Access(&facePlanes.i0[base]);
+                cache.Access(&facePlanes.i1[base]);
+                cache.Access(&facePlanes.i2[base]);
+                for (std::size_t lane = 0; lane < GeometryKernel::laneWidth; lane++)
+                {
+                    for (const auto* corners : {&facePlanes.i0, &facePlanes.i1, &facePlanes.i2})
+                    {
+                        const std::uint32_t v = (*corners)[base + lane];
+                        cache.Access(&vertexPlanes.x[v]);
+                        cache.Access(&vertexPlanes.y[v]);
+                        cache.Access(&vertexPlanes.z[v]);
+                        cache.Access(&uvPlanes.x[v]);
+                        cache.Access(&uvPlanes.y[v]);
+                    }
+                }
+                for (const auto* planes : {&faceNormals, &faceTangents, &faceBitangents})
+                {
+                    cache.Access(&planes->x[base]);
+                    cache.Access(&planes->y[base]);
+                    cache.Access(&planes->z[base]);
+                }
+            }
+            for (std::size_t i = 0; i < vertexToFaceMap.size(); i++)
+            {
+                cache.Access(&vertexToFaceMap.offsets[i]);
+                for (const auto& fi : vertexToFaceMap[i])
+                {
+                    cache.Access(&fi);
+                    cache.Access(&faceNormals.x[fi]);
+                    cache.Access(&faceNormals.y[fi]);
+                    cache.Access(&faceNormals.z[fi]);
+                }
+                cache.Access(&normals[i]);
+            }
+        }
+    };
+
+    // args: grid size, face order
+    void BM_NormalPasses(benchmark::State& state)
+    {
+        TBB_ThreadPool tp(1, 0);
+        const Mesh mesh = MakeMesh(static_cast<std::uint32_t>(state.range(0)));
+        const auto indices = Reorder(mesh, state.range(1), &tp);
+        NormalPasses passes(mesh, indices, &tp);
+        for (auto _ : state)
+        {
+            passes.Run();
+            benchmark::DoNotOptimize(passes.normals.data());
+        }
+
+        CacheHierarchy cache;
+        passes.Simulate(cache); // warm up, the passes run right after the topology is built
+        cache.l1.misses = 0;
+        cache.l2.misses = 0;
+        passes.Simulate(cache);
+        const double faceCount = static_cast<double>(indices.size() / 3);
+        state.counters["faces"] = faceCount;
+        state.counters["l1Miss/face"] = static_cast<double>(cache.l1.misses) / faceCount;
+        state.counters["l2Miss/face"] = static_cast<double>(cache.l2.misses) / faceCount;
+        state.SetLabel(GetOrderName(state.range(1)));
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(faceCount));
+    }
+}
+
+BENCHMARK(BM_NormalPasses)->ArgsProduct({{128, 512, 1024}, {Order::original, Order::uv, Order::vertex, Order::shuffled, Order::shuffledVertex}})->Unit(benchmark::kMillisecond);
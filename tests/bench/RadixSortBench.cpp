@@ -0,0 +1,71 @@
+#include "GeometryKernel.h"
+#include "TestSupport.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace Mus;
+
+namespace {
+    // the shape of PosEntry and the edge keys, a 64-bit key and a 32-bit payload
+    struct Entry {
+        std::uint64_t key;
+        std::uint32_t payload;
+        bool operator<(const Entry& other) const { return key < other.key; }
+    };
+
+    // args: count, key bits, welded positions and edges only use part of the key
+    std::vector<Entry> MakeEntries(const benchmark::State& state)
+    {
+        const auto count = static_cast<std::size_t>(state.range(0));
+        const auto bits = static_cast<std::uint32_t>(state.range(1));
+        const std::uint64_t mask = bits >= 64 ? ~0ull : ((1ull << bits) - 1);
+        std::mt19937_64 rng(1);
+        std::vector<Entry> entries(count);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            entries[i] = {rng() & mask, static_cast<std::uint32_t>(i)};
+        }
+        return entries;
+    }
+
+    TBB_ThreadPool& GetThreadPool()
+    {
+        static TBB_ThreadPool tp(std::max(1u, std::thread::hardware_concurrency()), 0);
+        return tp;
+    }
+
+    void BM_ParallelRadixSort(benchmark::State& state)
+    {
+        const auto source = MakeEntries(state);
+        std::vector<Entry> entries;
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            entries = source;
+            state.ResumeTiming();
+            parallel_radix_sort(entries, [](const Entry& e) { return e.key; }, &GetThreadPool());
+            benchmark::DoNotOptimize(entries.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void BM_TBBParallelSort(benchmark::State& state)
+    {
+        const auto source = MakeEntries(state);
+        std::vector<Entry> entries;
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            entries = source;
+            state.ResumeTiming();
+            GetThreadPool().Execute([&] {
+                tbb::parallel_sort(entries.begin(), entries.end());
+            });
+            benchmark::DoNotOptimize(entries.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+
+BENCHMARK(BM_ParallelRadixSort)->ArgsProduct({{100000, 500000, 1000000, 2000000}, {32, 64}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_TBBParallelSort)->ArgsProduct({{100000, 500000, 1000000, 2000000}, {32, 64}})->Unit(benchmark::kMillisecond)->UseRealTime();
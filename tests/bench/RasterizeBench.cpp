@@ -0,0 +1,100 @@
+#include "GeometryKernel.h"
+#include "TestSupport.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace Mus;
+
+namespace {
+    struct Triangle {
+        DirectX::XMINT2 a, b, c;
+        std::int32_t minX, minY, maxX, maxY;
+    };
+
+    // a uv grid of size x size texels split into cells of cellSize texels, two triangles per cell like a body mesh
+    std::vector<Triangle> MakeGrid(std::int32_t size, std::int32_t cellSize)
+    {
+        std::vector<Triangle> tris;
+        for (std::int32_t y = 0; y + cellSize <= size; y += cellSize)
+        {
+            for (std::int32_t x = 0; x + cellSize <= size; x += cellSize)
+            {
+                const DirectX::XMINT2 p00 = {x, y}, p10 = {x + cellSize, y}, p01 = {x, y + cellSize}, p11 = {x + cellSize, y + cellSize};
+                tris.push_back({p00, p10, p11, x, y, std::min(x + cellSize + 1, size), std::min(y + cellSize + 1, size)});
+                tris.push_back({p00, p11, p01, x, y, std::min(x + cellSize + 1, size), std::min(y + cellSize + 1, size)});
+            }
+        }
+        return tris;
+    }
+
+    // args: cell size in texels, kernel path (0 = reference, 1 = sse4, 2 = avx2)
+    void BM_RasterizeGrid(benchmark::State& state)
+    {
+        constexpr std::int32_t size = 1024;
+        const std::int32_t cellSize = static_cast<std::int32_t>(state.range(0));
+        const std::int64_t path = state.range(1);
+        if (path == 2 && !TestSupport::HasAVX2())
+        {
+            state.SkipWithError("no avx2");
+            return;
+        }
+        TestSupport::ScopedSIMDType scoped(path == 2 ? SIMDType::avx2 : SIMDType::sse4);
+        const auto tris = MakeGrid(size, cellSize);
+
+        std::vector<GeometryKernel::RasterSpan> spans;
+        std::vector<TestSupport::ReferencePixel> pixels;
+        std::int64_t covered = 0;
+        for (auto _ : state)
+        {
+            covered = 0;
+            for (const auto& tri : tris)
+            {
+                if (path == 0)
+                {
+                    TestSupport::RasterizeReference(tri.a, tri.b, tri.c, tri.minX, tri.minY, tri.maxX, tri.maxY, pixels);
+                    covered += static_cast<std::int64_t>(pixels.size());
+                }
+                else
+                {
+                    GeometryKernel::RasterizeTriangle(tri.a, tri.b, tri.c, tri.minX, tri.minY, tri.maxX, tri.maxY, spans);
+                    for (const auto& span : spans)
+                        covered += std::popcount(span.mask);
+                }
+            }
+            benchmark::DoNotOptimize(covered);
+        }
+        state.SetLabel(path == 0 ? "reference" : TestSupport::GetName(path == 2 ? SIMDType::avx2 : SIMDType::sse4));
+        state.counters["triangles"] = static_cast<double>(tris.size());
+        state.SetItemsProcessed(state.iterations() * covered);
+    }
+
+    // args: length in texels, kernel path, a one texel wide triangle along the diagonal
+    void BM_RasterizeSliver(benchmark::State& state)
+    {
+        const std::int32_t length = static_cast<std::int32_t>(state.range(0));
+        const std::int64_t path = state.range(1);
+        if (path == 2 && !TestSupport::HasAVX2())
+        {
+            state.SkipWithError("no avx2");
+            return;
+        }
+        TestSupport::ScopedSIMDType scoped(path == 2 ? SIMDType::avx2 : SIMDType::sse4);
+        const Triangle tri = {{0, 0}, {length, length - 1}, {length, length}, 0, 0, length + 1, length + 1};
+
+        std::vector<GeometryKernel::RasterSpan> spans;
+        std::vector<TestSupport::ReferencePixel> pixels;
+        for (auto _ : state)
+        {
+            if (path == 0)
+                TestSupport::RasterizeReference(tri.a, tri.b, tri.c, tri.minX, tri.minY, tri.maxX, tri.maxY, pixels);
+            else
+                GeometryKernel::RasterizeTriangle(tri.a, tri.b, tri.c, tri.minX, tri.minY, tri.maxX, tri.maxY, spans);
+            benchmark::DoNotOptimize(spans.data());
+            benchmark::DoNotOptimize(pixels.data());
+        }
+        state.SetLabel(path == 0 ? "reference" : TestSupport::GetName(path == 2 ? SIMDType::avx2 : SIMDType::sse4));
+    }
+}
+
+BENCHMARK(BM_RasterizeGrid)->ArgsProduct({{2, 4, 16, 64}, {0, 1, 2}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RasterizeSliver)->ArgsProduct({{256, 2048}, {0, 1, 2}})->Unit(benchmark::kMicrosecond);
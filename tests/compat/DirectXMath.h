@@ -0,0 +1,96 @@
+#pragma once
+
+// the subset of DirectXMath the portable kernels and their tests use, for hosts without the real headers
+// every function follows the SSE2 code path of DirectXMath, which is the one the plugin is built with
+
+#include <cstdint>
+#include <immintrin.h>
+
+#define XM_CALLCONV
+
+namespace DirectX {
+    using XMVECTOR = __m128;
+    using FXMVECTOR = const XMVECTOR;
+    using GXMVECTOR = const XMVECTOR;
+
+    struct XMFLOAT2 {
+        float x, y;
+        XMFLOAT2() = default;
+        constexpr XMFLOAT2(float _x, float _y) noexcept : x(_x), y(_y) {}
+    };
+    struct XMFLOAT3 {
+        float x, y, z;
+        XMFLOAT3() = default;
+        constexpr XMFLOAT3(float _x, float _y, float _z) noexcept : x(_x), y(_y), z(_z) {}
+    };
+    struct XMFLOAT4 {
+        float x, y, z, w;
+        XMFLOAT4() = default;
+        constexpr XMFLOAT4(float _x, float _y, float _z, float _w) noexcept : x(_x), y(_y), z(_z), w(_w) {}
+    };
+    struct XMINT2 {
+        std::int32_t x, y;
+        XMINT2() = default;
+        constexpr XMINT2(std::int32_t _x, std::int32_t _y) noexcept : x(_x), y(_y) {}
+    };
+
+    inline XMVECTOR XM_CALLCONV XMVectorSet(float x, float y, float z, float w) { return _mm_set_ps(w, z, y, x); }
+    inline XMVECTOR XM_CALLCONV XMVectorReplicate(float value) { return _mm_set_ps1(value); }
+    inline XMVECTOR XM_CALLCONV XMVectorZero() { return _mm_setzero_ps(); }
+
+    inline float XM_CALLCONV XMVectorGetX(FXMVECTOR V) { return _mm_cvtss_f32(V); }
+    inline float XM_CALLCONV XMVectorGetY(FXMVECTOR V) { return _mm_cvtss_f32(_mm_shuffle_ps(V, V, _MM_SHUFFLE(1, 1, 1, 1))); }
+    inline float XM_CALLCONV XMVectorGetZ(FXMVECTOR V) { return _mm_cvtss_f32(_mm_shuffle_ps(V, V, _MM_SHUFFLE(2, 2, 2, 2))); }
+
+    inline XMVECTOR XM_CALLCONV XMLoadFloat3(const XMFLOAT3* pSource) {
+        return _mm_set_ps(0.0f, pSource->z, pSource->y, pSource->x);
+    }
+    inline void XM_CALLCONV XMStoreFloat3(XMFLOAT3* pDestination, FXMVECTOR V) {
+        alignas(16) float f[4];
+        _mm_store_ps(f, V);
+        pDestination->x = f[0];
+        pDestination->y = f[1];
+        pDestination->z = f[2];
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorAdd(FXMVECTOR V1, FXMVECTOR V2) { return _mm_add_ps(V1, V2); }
+    inline XMVECTOR XM_CALLCONV XMVectorSubtract(FXMVECTOR V1, FXMVECTOR V2) { return _mm_sub_ps(V1, V2); }
+    inline XMVECTOR XM_CALLCONV XMVectorMultiply(FXMVECTOR V1, FXMVECTOR V2) { return _mm_mul_ps(V1, V2); }
+    inline XMVECTOR XM_CALLCONV XMVectorScale(FXMVECTOR V, float scaleFactor) { return _mm_mul_ps(V, _mm_set_ps1(scaleFactor)); }
+    inline XMVECTOR XM_CALLCONV XMVectorMultiplyAdd(FXMVECTOR V1, FXMVECTOR V2, FXMVECTOR V3) { return _mm_add_ps(_mm_mul_ps(V1, V2), V3); }
+
+    namespace Internal {
+        // x * x + y * y + z * z in every lane, added in the same order as DirectXMath
+        inline XMVECTOR XM_CALLCONV Dot3(FXMVECTOR V1, FXMVECTOR V2) {
+            XMVECTOR vDot = _mm_mul_ps(V1, V2);
+            XMVECTOR vTemp = _mm_shuffle_ps(vDot, vDot, _MM_SHUFFLE(2, 1, 2, 1));
+            vDot = _mm_add_ss(vDot, vTemp);
+            vTemp = _mm_shuffle_ps(vTemp, vTemp, _MM_SHUFFLE(1, 1, 1, 1));
+            vDot = _mm_add_ss(vDot, vTemp);
+            return _mm_shuffle_ps(vDot, vDot, _MM_SHUFFLE(0, 0, 0, 0));
+        }
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVector3Dot(FXMVECTOR V1, FXMVECTOR V2) { return Internal::Dot3(V1, V2); }
+    inline XMVECTOR XM_CALLCONV XMVector3LengthSq(FXMVECTOR V) { return Internal::Dot3(V, V); }
+    inline XMVECTOR XM_CALLCONV XMVector3Cross(FXMVECTOR V1, FXMVECTOR V2) {
+        XMVECTOR vTemp1 = _mm_shuffle_ps(V1, V1, _MM_SHUFFLE(3, 0, 2, 1));
+        XMVECTOR vTemp2 = _mm_shuffle_ps(V2, V2, _MM_SHUFFLE(3, 1, 0, 2));
+        XMVECTOR vResult = _mm_mul_ps(vTemp1, vTemp2);
+        vTemp1 = _mm_shuffle_ps(vTemp1, vTemp1, _MM_SHUFFLE(3, 0, 2, 1));
+        vTemp2 = _mm_shuffle_ps(vTemp2, vTemp2, _MM_SHUFFLE(3, 1, 0, 2));
+        vResult = _mm_sub_ps(vResult, _mm_mul_ps(vTemp1, vTemp2));
+        return _mm_and_ps(vResult, _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1)));
+    }
+    inline XMVECTOR XM_CALLCONV XMVector3NormalizeEst(FXMVECTOR V) {
+        return _mm_mul_ps(_mm_rsqrt_ps(Internal::Dot3(V, V)), V);
+    }
+    inline XMVECTOR XM_CALLCONV XMVector3Normalize(FXMVECTOR V) {
+        XMVECTOR vLengthSq = Internal::Dot3(V, V);
+        XMVECTOR vResult = _mm_sqrt_ps(vLengthSq);
+        const XMVECTOR vZeroMask = _mm_cmpneq_ps(_mm_setzero_ps(), vResult);
+        vLengthSq = _mm_cmpneq_ps(vLengthSq, _mm_castsi128_ps(_mm_set1_epi32(0x7F800000)));
+        vResult = _mm_and_ps(_mm_div_ps(V, vResult), vZeroMask);
+        return _mm_or_ps(_mm_andnot_ps(vLengthSq, _mm_castsi128_ps(_mm_set1_epi32(0x7FC00000))), _mm_and_ps(vResult, vLengthSq));
+    }
+}
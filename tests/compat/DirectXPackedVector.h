@@ -0,0 +1,46 @@
+#pragma once
+
+// the subset of DirectXPackedVector the portable kernels use, see DirectXMath.h next to it
+
+#include <cstdint>
+#include <cstring>
+
+namespace DirectX {
+    namespace PackedVector {
+        using HALF = std::uint16_t;
+
+        // the software conversion of DirectXMath, exact for every finite half
+        inline float XMConvertHalfToFloat(HALF Value) noexcept {
+            auto Mantissa = static_cast<std::uint32_t>(Value & 0x03FF);
+            std::uint32_t Exponent = (Value & 0x7C00);
+            if (Exponent == 0x7C00) // INF/NAN
+            {
+                Exponent = 0x8f;
+            }
+            else if (Exponent != 0) // normalized
+            {
+                Exponent = static_cast<std::uint32_t>((static_cast<int>(Value) >> 10) & 0x1F);
+            }
+            else if (Mantissa != 0) // denormalized, normalize it in the float
+            {
+                Exponent = 1;
+                do
+                {
+                    Exponent--;
+                    Mantissa <<= 1;
+                } while ((Mantissa & 0x0400) == 0);
+                Mantissa &= 0x03FF;
+            }
+            else // zero
+            {
+                Exponent = static_cast<std::uint32_t>(-112);
+            }
+            const std::uint32_t Result = ((static_cast<std::uint32_t>(Value) & 0x8000) << 16)
+                | ((Exponent + 112) << 23)
+                | (Mantissa << 13);
+            float f;
+            std::memcpy(&f, &Result, sizeof(f));
+            return f;
+        }
+    }
+}
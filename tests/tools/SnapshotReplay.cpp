@@ -0,0 +1,290 @@
+#include "GeometryKernel.h"
+#include "SnapshotFormat.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+
+// replays the portable stages of an update from a snapshot written by the plugin(export hotkey + F10 in game)
+// SnapshotReplay <file.mdnmsnap> [width height] [threads]
+// decode, face order, edge table, vertex to face map, face data, bake order and the uv rasterize run on the kernels of the plugin
+// the full PreProcessing to CompressTexture needs CommonLibSSE and D3D11, replay that in game with export hotkey + F9
+
+using namespace Mus;
+
+namespace {
+    using clock = std::chrono::steady_clock;
+
+    // read only mapping of a whole file
+    class MappedFile {
+    public:
+        MappedFile(const char* a_path) {
+            const int fd = open(a_path, O_RDONLY);
+            if (fd < 0)
+                return;
+            struct stat st;
+            if (fstat(fd, &st) == 0 && st.st_size > 0)
+            {
+                void* mapped = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED)
+                {
+                    data = static_cast<const std::uint8_t*>(mapped);
+                    size = static_cast<std::size_t>(st.st_size);
+                }
+            }
+            close(fd);
+        }
+        ~MappedFile() {
+            if (data)
+                munmap(const_cast<std::uint8_t*>(data), size);
+        }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool IsValid() const { return data != nullptr; }
+        std::span<const std::uint8_t> GetData() const { return {data, size}; }
+
+    private:
+        const std::uint8_t* data = nullptr;
+        std::size_t size = 0;
+    };
+
+    // RE::BSGraphics::VertexDesc, the size in dwords in the low 4 bits and the vertex flags from bit 44
+    constexpr std::uint64_t descFlagVertex = 1 << 0;
+    constexpr std::uint64_t descFlagUV = 1 << 1;
+    inline std::uint32_t GetVertexSize(std::uint64_t a_desc) { return static_cast<std::uint32_t>(a_desc & 0xF) * 4; }
+    inline bool HasFlag(std::uint64_t a_desc, std::uint64_t a_flag) { return ((a_desc >> 44) & a_flag) != 0; }
+
+    struct Geometry {
+        const Snapshot::GeometryRecord* record;
+        std::string_view name;
+        std::span<const std::uint8_t> geometryBlock;
+        std::span<const float> dynamicBlock1; // x y z per vertex
+        std::span<const DirectX::XMFLOAT4> dynamicBlock2;
+        std::span<const std::uint16_t> indicesBlock;
+        std::size_t indicesStart = 0, indicesEnd = 0;
+    };
+
+    struct Stage {
+        const char* name;
+        double ms;
+    };
+    class StageTimer {
+    public:
+        template <typename F>
+        void Run(const char* a_name, F&& f) {
+            const auto start = clock::now();
+            f();
+            stages.push_back({a_name, std::chrono::duration<double, std::milli>(clock::now() - start).count()});
+        }
+        void Print() const {
+            double total = 0.0;
+            for (const auto& stage : stages)
+            {
+                std::printf("  %-20s %10.3f ms\n", stage.name, stage.ms);
+                total += stage.ms;
+            }
+            std::printf("  %-20s %10.3f ms\n", "total", total);
+        }
+
+    private:
+        std::vector<Stage> stages;
+    };
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "usage: %s <file.mdnmsnap> [width height] [threads]\n", argv[0]);
+        return 2;
+    }
+    const std::int32_t width = argc > 3 ? std::atoi(argv[2]) : 2048;
+    const std::int32_t height = argc > 3 ? std::atoi(argv[3]) : 2048;
+    const std::uint32_t threads = argc > 4 ? static_cast<std::uint32_t>(std::atoi(argv[4])) : std::max(1u, std::thread::hardware_concurrency());
+    if (width <= 0 || height <= 0 || threads == 0)
+    {
+        std::fprintf(stderr, "invalid size or thread count\n");
+        return 2;
+    }
+    TBB_ThreadPool tp(threads, 0);
+    StageTimer timer;
+
+    std::unique_ptr<MappedFile> file;
+    Snapshot::FileView view;
+    bool valid = false;
+    timer.Run("map", [&] {
+        file = std::make_unique<MappedFile>(argv[1]);
+        valid = file->IsValid() && view.Parse(file->GetData());
+    });
+    if (!valid)
+    {
+        if (view.header && view.header->version != Snapshot::version)
+            std::fprintf(stderr, "%s : snapshot version %u, this build reads %u\n", argv[1], view.header->version, Snapshot::version);
+        else
+            std::fprintf(stderr, "%s : invalid snapshot\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<Geometry> geometries(view.records.size());
+    for (std::size_t i = 0; i < view.records.size(); i++)
+    {
+        const auto& record = view.records[i];
+        Geometry& geo = geometries[i];
+        geo.record = &record;
+        if (!view.GetString(record.name, geo.name)
+            || !view.GetBlock(record.geometryBlock, geo.geometryBlock)
+            || !view.GetBlock(record.dynamicBlock1, geo.dynamicBlock1)
+            || !view.GetBlock(record.dynamicBlock2, geo.dynamicBlock2)
+            || !view.GetBlock(record.indicesBlock, geo.indicesBlock)
+            || geo.geometryBlock.size() != static_cast<std::size_t>(record.vertexCount) * GetVertexSize(record.vertexDesc)
+            || (!geo.dynamicBlock1.empty() && geo.dynamicBlock1.size() != static_cast<std::size_t>(record.vertexCount) * 3)
+            || (!geo.dynamicBlock2.empty() && geo.dynamicBlock2.size() != record.vertexCount))
+        {
+            std::fprintf(stderr, "%s : invalid geometry record %zu\n", argv[1], i);
+            return 1;
+        }
+    }
+    // GetGeometryData merges the geometries in name order
+    std::sort(geometries.begin(), geometries.end(), [](const Geometry& a, const Geometry& b) {
+        return a.name < b.name;
+    });
+
+    std::vector<DirectX::XMFLOAT3> vertices;
+    std::vector<DirectX::XMFLOAT2> uvs;
+    std::vector<std::uint32_t> indices;
+    timer.Run("decode", [&] {
+        for (auto& geo : geometries)
+        {
+            const std::size_t beforeVertexCount = vertices.size();
+            const std::uint32_t vertexCount = geo.record->vertexCount;
+            vertices.resize(beforeVertexCount + vertexCount);
+            uvs.resize(beforeVertexCount + vertexCount);
+            if (!geo.dynamicBlock1.empty())
+                std::memcpy(&vertices[beforeVertexCount], geo.dynamicBlock1.data(), geo.dynamicBlock1.size_bytes());
+            else if (!geo.dynamicBlock2.empty())
+            {
+                for (std::size_t v = 0; v < vertexCount; v++)
+                    vertices[beforeVertexCount + v] = {geo.dynamicBlock2[v].x, geo.dynamicBlock2[v].y, geo.dynamicBlock2[v].z};
+            }
+
+            const std::uint64_t desc = geo.record->vertexDesc;
+            const std::uint32_t vertexSize = GetVertexSize(desc);
+            const std::uint32_t format = (HasFlag(desc, descFlagVertex) ? GeometryKernel::vertexFormatPosition : 0) |
+                                         (HasFlag(desc, descFlagUV) ? GeometryKernel::vertexFormatUV : 0);
+            const GeometryKernel::VertexDecoder decoder = GeometryKernel::GetVertexDecoder(format);
+            tp.Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, vertexCount, 1024),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                        decoder(geo.geometryBlock.data() + r.begin() * vertexSize, vertexSize, r.size(),
+                                vertices.data() + beforeVertexCount + r.begin(), uvs.data() + beforeVertexCount + r.begin());
+                    },
+                    tbb::auto_partitioner()
+                );
+            });
+
+            geo.indicesStart = indices.size();
+            for (const std::uint16_t index : geo.indicesBlock)
+                indices.push_back(static_cast<std::uint32_t>(beforeVertexCount + index));
+            indices.resize(geo.indicesStart + geo.indicesBlock.size() / 3 * 3);
+            geo.indicesEnd = indices.size();
+        }
+    });
+    const std::size_t faceCount = indices.size() / 3;
+
+    std::vector<std::uint32_t> faceOrder(faceCount);
+    timer.Run("face order", [&] {
+        for (const auto& geo : geometries)
+            GeometryKernel::BuildVertexOrder(indices, vertices.size(), geo.indicesStart / 3, geo.indicesEnd / 3, faceOrder, &tp);
+        std::vector<std::uint32_t> ordered(indices.size());
+        for (std::size_t f = 0; f < faceCount; f++)
+            std::memcpy(&ordered[f * 3], &indices[faceOrder[f] * 3], sizeof(std::uint32_t) * 3);
+        indices.swap(ordered);
+    });
+
+    GeometryKernel::EdgeTable edgeTable;
+    timer.Run("edge table", [&] { edgeTable.Build(indices, vertices.size(), &tp); });
+
+    GeometryKernel::AdjacencyList vertexToFaceMap;
+    timer.Run("vertex to face map", [&] { vertexToFaceMap.Build(vertices.size(), indices, 3, &tp); });
+
+    GeometryKernel::Float3Planes vertexPlanes, faceNormals, faceTangents, faceBitangents;
+    GeometryKernel::Float2Planes uvPlanes;
+    GeometryKernel::FacePlanes facePlanes;
+    timer.Run("face data", [&] {
+        vertexPlanes.Load(vertices, &tp);
+        uvPlanes.Load(uvs, &tp);
+        facePlanes.Load(indices, vertices.size(), &tp);
+        faceNormals.Resize(faceCount);
+        faceTangents.Resize(faceCount);
+        faceBitangents.Resize(faceCount);
+        tp.Execute([&] {
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>(0, GeometryKernel::BlockCount(faceCount)),
+                [&](const tbb::blocked_range<std::size_t>& r) {
+                    GeometryKernel::ComputeFaceData(vertexPlanes, uvPlanes, facePlanes, r.begin(), r.end(),
+                                                    faceNormals, faceTangents, faceBitangents);
+                },
+                tbb::auto_partitioner()
+            );
+        });
+    });
+
+    std::vector<std::uint32_t> bakeOrder(faceCount);
+    timer.Run("bake order", [&] {
+        for (const auto& geo : geometries)
+            GeometryKernel::BuildUVOrder(indices, uvs, geo.indicesStart / 3, geo.indicesEnd / 3, bakeOrder, &tp);
+    });
+
+    // the faces of the geometries in the update set, in bake order, every geometry on its own texture
+    std::atomic<std::uint64_t> covered = 0;
+    timer.Run("rasterize", [&] {
+        for (const auto& geo : geometries)
+        {
+            if (!(geo.record->flags & Snapshot::recordFlagUpdate))
+                continue;
+            tp.Execute([&] {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(geo.indicesStart / 3, geo.indicesEnd / 3, 256),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                        std::vector<GeometryKernel::RasterSpan> spans;
+                        std::uint64_t localCovered = 0;
+                        for (std::size_t i = r.begin(); i != r.end(); ++i)
+                        {
+                            const std::size_t index = static_cast<std::size_t>(bakeOrder[i]) * 3;
+                            if (indices[index + 0] >= uvs.size() || indices[index + 1] >= uvs.size() || indices[index + 2] >= uvs.size())
+                                continue;
+                            const DirectX::XMFLOAT2& u0 = uvs[indices[index + 0]];
+                            const DirectX::XMFLOAT2& u1 = uvs[indices[index + 1]];
+                            const DirectX::XMFLOAT2& u2 = uvs[indices[index + 2]];
+                            const DirectX::XMINT2 p0 = {static_cast<int>(u0.x * width), static_cast<int>(u0.y * height)};
+                            const DirectX::XMINT2 p1 = {static_cast<int>(u1.x * width), static_cast<int>(u1.y * height)};
+                            const DirectX::XMINT2 p2 = {static_cast<int>(u2.x * width), static_cast<int>(u2.y * height)};
+                            const std::int32_t minX = std::max(0, std::min({p0.x, p1.x, p2.x}));
+                            const std::int32_t minY = std::max(0, std::min({p0.y, p1.y, p2.y}));
+                            const std::int32_t maxX = std::min(width - 1, std::max({p0.x, p1.x, p2.x}) + 1);
+                            const std::int32_t maxY = std::min(height - 1, std::max({p0.y, p1.y, p2.y}) + 1);
+                            if (minX >= maxX || minY >= maxY)
+                                continue;
+                            GeometryKernel::RasterizeTriangle(p0, p1, p2, minX, minY, maxX, maxY, spans);
+                            for (const auto& span : spans)
+                                localCovered += std::popcount(span.mask);
+                        }
+                        covered += localCovered;
+                    },
+                    tbb::auto_partitioner()
+                );
+            });
+        }
+    });
+
+    std::printf("%s : actor %08X, %zu geometries, %zu vertices, %zu faces, %zu edges, %dx%d, %u threads, %llu texels\n",
+                argv[1], view.header->actorID, geometries.size(), vertices.size(), faceCount, edgeTable.size(),
+                width, height, threads, static_cast<unsigned long long>(covered.load()));
+    timer.Print();
+    return 0;
+}